@@ -1,7 +1,12 @@
 #pragma once
+#include <functional>
+
 #include "definitions.hpp"
 
 namespace rankup {
+// the number of distinct cards in a deck, including the two jokers
+inline constexpr int NUM_CARD_KINDS = 54;
+
 struct Card {
  private:
   Suit m_s;
@@ -13,12 +18,43 @@ struct Card {
   constexpr const Suit& suit() const noexcept { return m_s; }
   constexpr const Rank& rank() const noexcept { return m_r; }
 
-  constexpr bool operator!=(const Card& other) noexcept {
+  /**
+     @return an index in [0, NUM_CARD_KINDS) unique to each card of a deck.
+     Folk suits take 13 indices each in the order of Suit, followed by the
+     low and the high joker.
+   */
+  constexpr int8_t index() const noexcept {
+    constexpr int8_t w = static_cast<int8_t>(Rank::_w);
+    return m_s != Suit::J
+               ? static_cast<int8_t>(m_s) * 13 + static_cast<int8_t>(m_r)
+               : 52 + static_cast<int8_t>(m_r) - w;
+  }
+
+  /**
+     The inverse of index().
+   */
+  static constexpr Card from_index(int8_t index) noexcept {
+    constexpr int8_t w = static_cast<int8_t>(Rank::_w);
+    return index < 52 ? Card(static_cast<Suit>(index / 13),
+                             static_cast<Rank>(index % 13))
+                      : Card(Suit::J, static_cast<Rank>(index - 52 + w));
+  }
+
+  constexpr bool operator!=(const Card& other) const noexcept {
     return (m_s != other.m_s) or (m_r != other.m_r);
   }
 
-  constexpr bool operator==(const Card& other) noexcept {
+  constexpr bool operator==(const Card& other) const noexcept {
     return !(*this != other);
   }
 };
-}  // namespace rankup
\ No newline at end of file
+}  // namespace rankup
+
+namespace std {
+template <>
+struct hash<rankup::Card> {
+  std::size_t operator()(const rankup::Card& card) const noexcept {
+    return static_cast<std::size_t>(card.index());
+  }
+};
+}  // namespace std
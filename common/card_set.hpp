@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "card.hpp"
+
+namespace rankup {
+// the number of decks in a game
+inline constexpr int NUM_DECKS = 2;
+
+// the number of players in a game
+inline constexpr int NUM_SEATS = 4;
+
+// the bits over Card::index() of every kind of card
+inline constexpr std::uint64_t ALL_CARD_BITS =
+    (std::uint64_t(1) << NUM_CARD_KINDS) - 1;
+
+/**
+   @return the points of card, i.e. 5 for a 5, 10 for a 10 or a K, and 0
+   otherwise
+ */
+constexpr int points_of(const Card& card) noexcept {
+  if (card.suit() == Suit::J) return 0;
+  switch (card.rank()) {
+    case Rank::_5:
+      return 5;
+    case Rank::_10:
+    case Rank::_K:
+      return 10;
+    default:
+      return 0;
+  }
+}
+
+namespace detail {
+// the bits over Card::index() of rank in the four folk suits
+constexpr std::uint64_t folk_bits_of(Rank rank) noexcept {
+  std::uint64_t res = 0;
+  for (int s = 0; s < 4; ++s)
+    res |= std::uint64_t(1) << Card(static_cast<Suit>(s), rank).index();
+  return res;
+}
+}  // namespace detail
+
+/**
+   A multiset of cards from two decks, stored as two bitmasks over
+   Card::index(). The bit of a card is set in once() if the set has at least
+   one copy of it, and in twice() if the set has both copies. So twice() is
+   always a subset of once().
+ */
+class CardSet {
+ public:
+  constexpr CardSet() = default;
+  constexpr CardSet(std::uint64_t once, std::uint64_t twice)
+      : m_once(once), m_twice(twice) {}
+
+  explicit CardSet(const std::vector<Card>& cards) {
+    for (const auto& card : cards) add(card);
+  }
+
+  constexpr std::uint64_t once() const noexcept { return m_once; }
+  constexpr std::uint64_t twice() const noexcept { return m_twice; }
+
+  static constexpr std::uint64_t bit(const Card& card) noexcept {
+    return std::uint64_t(1) << card.index();
+  }
+
+  /**
+     @return the number of copies of card in the set, i.e. 0, 1 or 2
+   */
+  constexpr int8_t count(const Card& card) const noexcept {
+    return ((m_once >> card.index()) & 1) + ((m_twice >> card.index()) & 1);
+  }
+
+  bool contains(const Card& card) const noexcept {
+    return m_once & bit(card);
+  }
+
+  int size() const noexcept {
+    return __builtin_popcountll(m_once) + __builtin_popcountll(m_twice);
+  }
+
+  bool empty() const noexcept { return m_once == 0; }
+
+  /**
+     @return the total points of the cards
+   */
+  int points() const noexcept {
+    constexpr auto FIVES = detail::folk_bits_of(Rank::_5);
+    constexpr auto TENS_AND_KINGS =
+        detail::folk_bits_of(Rank::_10) | detail::folk_bits_of(Rank::_K);
+    return 5 * (__builtin_popcountll(m_once & FIVES) +
+                __builtin_popcountll(m_twice & FIVES)) +
+           10 * (__builtin_popcountll(m_once & TENS_AND_KINGS) +
+                 __builtin_popcountll(m_twice & TENS_AND_KINGS));
+  }
+
+  /**
+     Add one copy of card. The set must not have both copies already.
+   */
+  void add(const Card& card) noexcept {
+    const auto b = bit(card);
+    assert(!(m_twice & b));
+    if (m_once & b)
+      m_twice |= b;
+    else
+      m_once |= b;
+  }
+
+  /**
+     Remove one copy of card. The set must have at least one copy.
+   */
+  void remove(const Card& card) noexcept {
+    const auto b = bit(card);
+    assert(m_once & b);
+    if (m_twice & b)
+      m_twice &= ~b;
+    else
+      m_once &= ~b;
+  }
+
+  /**
+     @return whether every copy of this set is also in other
+   */
+  bool is_subset_of(const CardSet& other) const noexcept {
+    return !(m_once & ~other.m_once) and !(m_twice & ~other.m_twice);
+  }
+
+  /**
+     Add all cards of other. The result must not exceed two copies per card.
+   */
+  CardSet& operator+=(const CardSet& other) noexcept {
+    assert(!(m_twice & other.m_once) and !(m_once & other.m_twice));
+    m_twice |= (m_once & other.m_once) | other.m_twice;
+    m_once |= other.m_once;
+    return *this;
+  }
+
+  /**
+     Remove all cards of other, which must be a subset of this set.
+   */
+  CardSet& operator-=(const CardSet& other) noexcept {
+    assert(other.is_subset_of(*this));
+    // a card with two copies here and one copy in other keeps one copy
+    const auto left_once = m_twice & ~other.m_twice & other.m_once;
+    m_once = (m_once & ~other.m_once) | left_once;
+    m_twice &= ~other.m_once;
+    return *this;
+  }
+
+  /**
+     @return the cards in the order of Card::index(), with two copies listed
+     next to each other
+   */
+  std::vector<Card> to_vector() const {
+    std::vector<Card> res;
+    res.reserve(size());
+    for (auto m = m_once; m; m &= m - 1) {
+      const int8_t index = __builtin_ctzll(m);
+      res.push_back(Card::from_index(index));
+      if ((m_twice >> index) & 1) res.push_back(Card::from_index(index));
+    }
+    return res;
+  }
+
+  constexpr bool operator==(const CardSet& other) const noexcept {
+    return m_once == other.m_once and m_twice == other.m_twice;
+  }
+
+  constexpr bool operator!=(const CardSet& other) const noexcept {
+    return !(*this == other);
+  }
+
+ private:
+  std::uint64_t m_once = 0;
+  std::uint64_t m_twice = 0;
+};
+
+namespace detail {
+template <typename F>
+void for_each_subset(std::uint64_t once, std::uint64_t twice, int size,
+                     int num_left, CardSet& subset, F& f) {
+  if (size == 0) {
+    f(static_cast<const CardSet&>(subset));
+    return;
+  }
+  if (num_left < size) return;
+
+  const int8_t index = __builtin_ctzll(once);
+  const auto b = std::uint64_t(1) << index;
+  const int count = (twice & b) ? 2 : 1;
+  once &= ~b;
+  twice &= ~b;
+  num_left -= count;
+
+  const auto card = Card::from_index(index);
+  for_each_subset(once, twice, size, num_left, subset, f);
+  subset.add(card);
+  for_each_subset(once, twice, size - 1, num_left, subset, f);
+  if (count == 2 and size >= 2) {
+    subset.add(card);
+    for_each_subset(once, twice, size - 2, num_left, subset, f);
+    subset.remove(card);
+  }
+  subset.remove(card);
+}
+}  // namespace detail
+
+/**
+   Call f(subset) on every distinct sub-multiset of `set` with `size` cards.
+   Copies of the same card are not told apart, e.g. {A, A, B} has the subsets
+   {A, A} and {A, B} of size 2.
+ */
+template <typename F>
+void for_each_subset(const CardSet& set, int size, F&& f) {
+  CardSet subset;
+  detail::for_each_subset(set.once(), set.twice(), size, set.size(), subset,
+                          f);
+}
+}  // namespace rankup
@@ -8,6 +8,9 @@ using std::int8_t;
 
 enum class Suit : int8_t { D = 0, C, H, S, J };
 
+// the number of suits a card can belong to once lorded, i.e. of Suit
+inline constexpr int NUM_LORDED_SUITS = 5;
+
 // _w is Joker low, and _W is Joker high
 enum class Rank : int8_t {
   _2 = 0,
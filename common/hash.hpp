@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace rankup {
+/**
+   The finalizer of splitmix64. It is a bijection on 64-bit integers that
+   spreads every input bit over the whole output.
+ */
+constexpr std::uint64_t mix64(std::uint64_t x) noexcept {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/**
+   The splitmix64 generator, which is good enough to seed Zobrist keys and
+   per-thread random engines.
+
+   @return the next output, advancing state
+ */
+constexpr std::uint64_t splitmix64(std::uint64_t& state) noexcept {
+  state += 0x9e3779b97f4a7c15ULL;
+  return mix64(state);
+}
+}  // namespace rankup
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace rankup {
+// the number of strengths of a lorded suit, so that the strengths of the
+// cards of a suit fit in a 16-bit mask, bit s for strength s
+inline constexpr int NUM_STRENGTHS = 16;
+
+/**
+   @return the bits of mask starting runs of at least length bits, e.g. the
+   lowest strengths of the tractors of length pairs in a mask of pairs
+ */
+constexpr std::uint32_t runs_of(std::uint32_t mask, int length) noexcept {
+  auto res = mask;
+  for (int i = 1; i < length; ++i) res &= mask >> i;
+  return res;
+}
+
+/**
+   @return the index of the highest bit of mask, or -1 if mask is 0
+ */
+constexpr int highest_bit(std::uint32_t mask) noexcept {
+  return mask ? 31 - __builtin_clz(mask) : -1;
+}
+}  // namespace rankup
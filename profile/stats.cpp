@@ -0,0 +1,116 @@
+#include "profile/stats.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace rankup::stats {
+namespace {
+struct Registry {
+  std::mutex mtx;
+  std::vector<detail::Block*> live;
+  // totals of threads that have exited
+  Snapshot retired;
+};
+
+Registry& registry() {
+  // intentionally leaked so that blocks of threads exiting after main() can
+  // still unregister safely
+  static auto* reg = new Registry;
+  return *reg;
+}
+}  // namespace
+
+const char* site_name(Site site) {
+  switch (site) {
+    case Site::MINOR_LORD_SHIFT_LEFT:
+      return "minor_lord_shift_left";
+    case Site::MINOR_LORD_SHIFT_RIGHT:
+      return "minor_lord_shift_right";
+    case Site::MINOR_LORD_EXTRACT:
+      return "minor_lord_extract";
+    case Site::SPLIT_MERGE_EXTRA:
+      return "split_merge_extra";
+    case Site::GET_START_MAP:
+      return "get_start_map";
+    case Site::EXCEPTION:
+      return "exception";
+    default:
+      return "unknown";
+  }
+}
+
+namespace detail {
+Block::Block() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mtx);
+  reg.live.push_back(this);
+}
+
+Block::~Block() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mtx);
+  for (int i = 0; i < NUM_SITES; ++i) {
+    reg.retired.count[i] += count[i].load(std::memory_order_relaxed);
+    reg.retired.nanoseconds[i] +=
+        nanoseconds[i].load(std::memory_order_relaxed);
+  }
+  reg.live.erase(std::find(reg.live.begin(), reg.live.end(), this));
+}
+
+Block& local_block() {
+  thread_local Block block;
+  return block;
+}
+}  // namespace detail
+
+Snapshot snapshot() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mtx);
+  Snapshot res = reg.retired;
+  for (const auto* block : reg.live) {
+    for (int i = 0; i < NUM_SITES; ++i) {
+      res.count[i] += block->count[i].load(std::memory_order_relaxed);
+      res.nanoseconds[i] +=
+          block->nanoseconds[i].load(std::memory_order_relaxed);
+    }
+  }
+  return res;
+}
+
+void reset() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mtx);
+  reg.retired = Snapshot();
+  for (auto* block : reg.live) {
+    for (int i = 0; i < NUM_SITES; ++i) {
+      block->count[i].store(0, std::memory_order_relaxed);
+      block->nanoseconds[i].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+void dump_at_exit() {
+  static std::once_flag flag;
+  std::call_once(flag, [] {
+    std::atexit([] {
+      auto str = static_cast<std::string>(snapshot());
+      std::fputs(str.c_str(), stderr);
+    });
+  });
+}
+
+Snapshot::operator std::string() const {
+  std::ostringstream ss;
+  ss << "rankup stats:\n";
+  for (int i = 0; i < NUM_SITES; ++i) {
+    ss << "  " << site_name(static_cast<Site>(i)) << ": count " << count[i];
+    if (nanoseconds[i] != 0) ss << ", " << nanoseconds[i] << " ns";
+    ss << "\n";
+  }
+  return ss.str();
+}
+}  // namespace rankup::stats
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace rankup::stats {
+
+/**
+   Instrumented sites. The counters of a site count how many times the site is
+   hit, and its timer accumulates the nanoseconds spent within the site if the
+   site is timed with RANKUP_STATS_TIMER.
+ */
+enum class Site : int {
+  // the three ways a pair of minor lords may join its neighbors
+  MINOR_LORD_SHIFT_LEFT = 0,
+  MINOR_LORD_SHIFT_RIGHT,
+  MINOR_LORD_EXTRACT,
+  SPLIT_MERGE_EXTRA,
+  GET_START_MAP,
+  EXCEPTION,
+  NUM_SITES
+};
+
+inline constexpr int NUM_SITES = static_cast<int>(Site::NUM_SITES);
+
+const char* site_name(Site site);
+
+/**
+   Aggregated counters over all threads, including those already exited.
+ */
+struct Snapshot {
+  std::array<std::uint64_t, NUM_SITES> count{};
+  std::array<std::uint64_t, NUM_SITES> nanoseconds{};
+
+  std::uint64_t count_at(Site site) const {
+    return count[static_cast<int>(site)];
+  }
+  std::uint64_t nanoseconds_at(Site site) const {
+    return nanoseconds[static_cast<int>(site)];
+  }
+
+  explicit operator std::string() const;
+};
+
+template <typename OStream>
+OStream& operator<<(OStream& o, const Snapshot& snapshot) {
+  o << static_cast<std::string>(snapshot);
+  return o;
+}
+
+Snapshot snapshot();
+
+/**
+   Zero all counters. Counts recorded concurrently by other threads may or may
+   not survive the reset.
+ */
+void reset();
+
+/**
+   Print the snapshot to stderr when the program exits. Calling it more than
+   once has no additional effect.
+ */
+void dump_at_exit();
+
+namespace detail {
+// Each thread owns one block and is its only writer, so updates are plain
+// relaxed load-store pairs rather than read-modify-write operations.
+struct Block {
+  Block();
+  ~Block();
+
+  std::array<std::atomic<std::uint64_t>, NUM_SITES> count{};
+  std::array<std::atomic<std::uint64_t>, NUM_SITES> nanoseconds{};
+};
+
+Block& local_block();
+
+inline void bump(std::atomic<std::uint64_t>& c, std::uint64_t delta) {
+  c.store(c.load(std::memory_order_relaxed) + delta,
+          std::memory_order_relaxed);
+}
+}  // namespace detail
+
+inline void count(Site site) {
+  detail::bump(detail::local_block().count[static_cast<int>(site)], 1);
+}
+
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(Site site)
+      : m_site(static_cast<int>(site)),
+        m_begin(std::chrono::steady_clock::now()) {}
+
+  ~ScopedTimer() {
+    auto elapsed = std::chrono::steady_clock::now() - m_begin;
+    auto& block = detail::local_block();
+    detail::bump(block.count[m_site], 1);
+    detail::bump(
+        block.nanoseconds[m_site],
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  int m_site;
+  std::chrono::steady_clock::time_point m_begin;
+};
+
+}  // namespace rankup::stats
+
+// The macros below are the only intended way of instrumenting library code.
+// They compile to nothing unless RANKUP_STATS is defined.
+#ifdef RANKUP_STATS
+#define RANKUP_STATS_COUNT(site) \
+  ::rankup::stats::count(::rankup::stats::Site::site)
+#define RANKUP_STATS_TIMER(site) \
+  ::rankup::stats::ScopedTimer rankup_stats_timer(::rankup::stats::Site::site)
+#else
+#define RANKUP_STATS_COUNT(site) ((void)0)
+#define RANKUP_STATS_TIMER(site) ((void)0)
+#endif
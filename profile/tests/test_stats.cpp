@@ -0,0 +1,48 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include <thread>
+
+#include "profile/stats.hpp"
+
+using namespace rankup;
+
+SCENARIO("stats counters and timers", "[profile]") {
+  stats::reset();
+  REQUIRE(stats::snapshot().count_at(stats::Site::SPLIT_MERGE_EXTRA) == 0);
+
+  SECTION("counts from the calling thread") {
+    for (int i = 0; i < 3; ++i) stats::count(stats::Site::EXCEPTION);
+    const auto snap = stats::snapshot();
+    CHECK(snap.count_at(stats::Site::EXCEPTION) == 3);
+    CHECK(snap.count_at(stats::Site::GET_START_MAP) == 0);
+  }
+
+  SECTION("timers count as well as accumulate time") {
+    { stats::ScopedTimer timer(stats::Site::GET_START_MAP); }
+    { stats::ScopedTimer timer(stats::Site::GET_START_MAP); }
+    const auto snap = stats::snapshot();
+    CHECK(snap.count_at(stats::Site::GET_START_MAP) == 2);
+  }
+
+  SECTION("counts of exited threads are kept") {
+    std::thread t1([] { stats::count(stats::Site::MINOR_LORD_EXTRACT); });
+    std::thread t2([] { stats::count(stats::Site::MINOR_LORD_EXTRACT); });
+    t1.join();
+    t2.join();
+    CHECK(stats::snapshot().count_at(stats::Site::MINOR_LORD_EXTRACT) == 2);
+  }
+
+  SECTION("reset zeroes everything") {
+    stats::count(stats::Site::MINOR_LORD_SHIFT_LEFT);
+    stats::reset();
+    CHECK(stats::snapshot().count_at(stats::Site::MINOR_LORD_SHIFT_LEFT) == 0);
+  }
+
+  SECTION("snapshot prints every site") {
+    auto str = static_cast<std::string>(stats::snapshot());
+    for (int i = 0; i < stats::NUM_SITES; ++i) {
+      CHECK(str.find(stats::site_name(static_cast<stats::Site>(i))) !=
+            std::string::npos);
+    }
+  }
+}
@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "profile/trace.hpp"
+
+using namespace rankup;
+
+namespace {
+std::string read_file(const std::string& path) {
+  std::ifstream in(path);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+}  // namespace
+
+SCENARIO("trace spans are written as Chrome trace events", "[profile]") {
+  const std::string path = "test_trace_output.json";
+  trace::clear();
+
+  SECTION("spans are not recorded before start") {
+    { trace::Span span("ignored"); }
+    CHECK(trace::write_chrome_trace(path) == 0);
+  }
+
+  SECTION("nested spans from several threads") {
+    trace::start(4);
+    {
+      trace::Span outer("outer");
+      trace::Span inner("inner");
+    }
+    std::thread t([] { trace::Span span("worker"); });
+    t.join();
+    trace::stop();
+    { trace::Span span("after_stop"); }
+
+    CHECK(trace::write_chrome_trace(path) == 3);
+    const auto json = read_file(path);
+    CHECK(json.find("\"name\":\"outer\"") != std::string::npos);
+    CHECK(json.find("\"name\":\"inner\"") != std::string::npos);
+    CHECK(json.find("\"name\":\"worker\"") != std::string::npos);
+    CHECK(json.find("after_stop") == std::string::npos);
+    CHECK(json.find("\"ph\":\"X\"") != std::string::npos);
+  }
+
+  SECTION("spans beyond the buffer capacity are dropped") {
+    trace::start(4);
+    std::thread t([] {
+      for (int i = 0; i < 6; ++i) trace::Span span("span");
+    });
+    t.join();
+    trace::stop();
+    CHECK(trace::num_dropped() == 2);
+    CHECK(trace::write_chrome_trace(path) == 4);
+  }
+
+  SECTION("threads spawned one after another keep their own ids") {
+    auto num_threads = [&path]() {
+      trace::write_chrome_trace(path);
+      const auto json = read_file(path);
+      int res = 0;
+      for (auto i = json.find("thread_name"); i != std::string::npos;
+           i = json.find("thread_name", i + 1))
+        ++res;
+      return res;
+    };
+
+    trace::start(10000);
+    for (int t = 0; t < 8; ++t) {
+      std::thread thread([] {
+        for (int i = 0; i < 500; ++i) trace::Span span("span");
+      });
+      thread.join();
+    }
+    trace::stop();
+    CHECK(num_threads() == 8);
+    CHECK(trace::write_chrome_trace(path) == 4000);
+    CHECK(trace::num_dropped() == 0);
+  }
+
+  SECTION("a new capacity applies to the buffers already taken") {
+    trace::start(2);
+    for (int i = 0; i < 3; ++i) trace::Span span("span");
+    CHECK(trace::num_dropped() == 1);
+    trace::clear();
+    trace::start(6);
+    for (int i = 0; i < 3; ++i) trace::Span span("span");
+    trace::stop();
+    CHECK(trace::num_dropped() == 0);
+    CHECK(trace::write_chrome_trace(path) == 3);
+  }
+
+  std::remove(path.c_str());
+}
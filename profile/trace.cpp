@@ -0,0 +1,198 @@
+#include "profile/trace.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace rankup::trace {
+namespace {
+struct Event {
+  const char* name;
+  std::uint64_t begin;
+  std::uint64_t end;
+  // the id of the thread that recorded the event, as buffers outlive threads
+  int tid;
+};
+
+// events are allocated in chunks of this many as a buffer fills up
+constexpr std::size_t CHUNK_SIZE = 4096;
+
+// A buffer is written only by the thread holding it. `size` is published with
+// release semantics so that a reader sees complete events.
+struct ThreadBuffer {
+  Event& operator[](std::size_t i) {
+    return chunks[i / CHUNK_SIZE][i % CHUNK_SIZE];
+  }
+
+  // the id of the thread holding the buffer
+  int tid = 0;
+  // the largest number of events, set by start()
+  std::atomic<std::size_t> capacity{0};
+  std::vector<std::unique_ptr<Event[]>> chunks;
+  std::atomic<std::size_t> size{0};
+  std::atomic<std::size_t> dropped{0};
+};
+
+struct Registry {
+  std::mutex mtx;
+  // buffers are owned here so that they outlive their threads
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  // the buffers of exited threads, to be taken by new ones
+  std::vector<ThreadBuffer*> free_buffers;
+  std::size_t capacity = 0;
+  int next_tid = 0;
+
+  // pairs of tick and wall time used to convert ticks to microseconds
+  std::uint64_t tick_origin = 0;
+  std::chrono::steady_clock::time_point wall_origin;
+};
+
+Registry& registry() {
+  static auto* reg = new Registry;
+  return *reg;
+}
+
+// The buffer of a thread, taken on its first span and given back when it
+// exits, so that threads spawned over and over, e.g. by parallel_for, share
+// a few buffers instead of leaking one each. Every thread gets an id of its
+// own, and the spans of the previous holders of its buffer are kept.
+class BufferLease {
+ public:
+  BufferLease() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mtx);
+    if (reg.free_buffers.empty()) {
+      reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+      m_buf = reg.buffers.back().get();
+      m_buf->capacity.store(reg.capacity, std::memory_order_relaxed);
+    } else {
+      m_buf = reg.free_buffers.back();
+      reg.free_buffers.pop_back();
+    }
+    m_buf->tid = reg.next_tid++;
+  }
+
+  ~BufferLease() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mtx);
+    reg.free_buffers.push_back(m_buf);
+  }
+
+  BufferLease(const BufferLease&) = delete;
+  BufferLease& operator=(const BufferLease&) = delete;
+
+  ThreadBuffer& operator*() const { return *m_buf; }
+
+ private:
+  ThreadBuffer* m_buf;
+};
+}  // namespace
+
+void start(std::size_t events_per_thread) {
+  auto& reg = registry();
+  {
+    std::lock_guard<std::mutex> lock(reg.mtx);
+    reg.capacity = events_per_thread;
+    for (auto& buf : reg.buffers)
+      buf->capacity.store(events_per_thread, std::memory_order_relaxed);
+    if (reg.tick_origin == 0) {
+      reg.tick_origin = detail::now();
+      reg.wall_origin = std::chrono::steady_clock::now();
+    }
+  }
+  detail::g_enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop() { detail::g_enabled.store(false, std::memory_order_relaxed); }
+
+void clear() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mtx);
+  for (auto& buf : reg.buffers) {
+    buf->size.store(0, std::memory_order_relaxed);
+    buf->dropped.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::size_t num_dropped() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mtx);
+  std::size_t res = 0;
+  for (const auto& buf : reg.buffers)
+    res += buf->dropped.load(std::memory_order_relaxed);
+  return res;
+}
+
+namespace detail {
+void record(const char* name, std::uint64_t begin, std::uint64_t end) {
+  thread_local BufferLease lease;
+  auto& buf = *lease;
+  auto idx = buf.size.load(std::memory_order_relaxed);
+  if (idx < buf.capacity.load(std::memory_order_relaxed)) {
+    if (idx / CHUNK_SIZE == buf.chunks.size())
+      buf.chunks.emplace_back(new Event[CHUNK_SIZE]);
+    buf[idx] = {name, begin, end, buf.tid};
+    buf.size.store(idx + 1, std::memory_order_release);
+  } else {
+    buf.dropped.store(buf.dropped.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+  }
+}
+}  // namespace detail
+
+std::size_t write_chrome_trace(const std::string& path) {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mtx);
+
+  std::ofstream out(path);
+  if (!out) {
+    throw std::runtime_error("trace::write_chrome_trace cannot open " + path);
+  }
+
+  // calibrate ticks against the wall clock over the whole recording
+  const auto tick_now = detail::now();
+  const auto wall_now = std::chrono::steady_clock::now();
+  const double wall_us =
+      std::chrono::duration<double, std::micro>(wall_now - reg.wall_origin)
+          .count();
+  const double us_per_tick =
+      tick_now > reg.tick_origin ? wall_us / (tick_now - reg.tick_origin) : 0.0;
+  auto to_us = [&](std::uint64_t tick) {
+    return tick > reg.tick_origin ? (tick - reg.tick_origin) * us_per_tick
+                                  : 0.0;
+  };
+
+  std::size_t num_written = 0;
+  out << std::fixed << std::setprecision(3);
+  out << "{\"traceEvents\":[";
+  const char* sep = "\n";
+  for (const auto& buf : reg.buffers) {
+    const auto size = buf->size.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < size; ++i) {
+      const auto& e = (*buf)[i];
+      // the spans of a thread are contiguous in its buffer
+      if (i == 0 or e.tid != (*buf)[i - 1].tid) {
+        out << sep
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << e.tid << ",\"args\":{\"name\":\"thread " << e.tid << "\"}}";
+        sep = ",\n";
+      }
+      out << sep << "{\"name\":\"" << e.name
+          << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.tid
+          << ",\"ts\":" << to_us(e.begin)
+          << ",\"dur\":" << (to_us(e.end) - to_us(e.begin)) << "}";
+      ++num_written;
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+  if (!out) {
+    throw std::runtime_error("trace::write_chrome_trace failed writing " +
+                             path);
+  }
+  return num_written;
+}
+}  // namespace rankup::trace
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace rankup::trace {
+
+/**
+   Start recording spans. Each thread records into its own buffer of up to
+   `events_per_thread` spans, grown in chunks as spans are recorded, and the
+   capacity applies to the buffers already taken too. Spans beyond the
+   capacity of a buffer are dropped. The buffer of an exited thread, with its
+   spans, is taken over by the next new thread to record a span, which records
+   under a thread id of its own.
+ */
+void start(std::size_t events_per_thread = std::size_t(1) << 20);
+
+/**
+   Stop recording spans. Recorded spans are kept until `clear`.
+ */
+void stop();
+
+/**
+   Discard all recorded spans. Must not race with threads recording spans.
+ */
+void clear();
+
+/**
+   Write all recorded spans as Chrome trace-event JSON, which can be loaded in
+   chrome://tracing or Perfetto. Must not race with threads recording spans.
+
+   @return the number of spans written
+
+   @throw std::runtime_error if the file cannot be written.
+ */
+std::size_t write_chrome_trace(const std::string& path);
+
+/**
+   @return the number of spans dropped due to full buffers
+ */
+std::size_t num_dropped();
+
+namespace detail {
+inline std::atomic<bool> g_enabled{false};
+
+inline std::uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+void record(const char* name, std::uint64_t begin, std::uint64_t end);
+}  // namespace detail
+
+/**
+   A span covering the lifetime of this object. `name` must outlive the
+   recording, e.g. a string literal.
+ */
+class Span {
+ public:
+  explicit Span(const char* name)
+      : m_name(name),
+        m_enabled(detail::g_enabled.load(std::memory_order_relaxed)),
+        m_begin(m_enabled ? detail::now() : 0) {}
+
+  ~Span() {
+    if (m_enabled) detail::record(m_name, m_begin, detail::now());
+  }
+
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+ private:
+  const char* m_name;
+  bool m_enabled;
+  std::uint64_t m_begin;
+};
+
+}  // namespace rankup::trace
+
+// RANKUP_TRACE_SCOPE compiles to nothing unless RANKUP_TRACE is defined.
+#ifdef RANKUP_TRACE
+#define RANKUP_TRACE_SCOPE(name) ::rankup::trace::Span rankup_trace_span(name)
+#else
+#define RANKUP_TRACE_SCOPE(name) ((void)0)
+#endif
@@ -3,6 +3,7 @@
 %{
 #include "common/card.hpp"
 #include "rules/rules.hpp"
+#include "rules/hand_structure.hpp"
 %}
 
 // class Card
@@ -15,6 +16,9 @@
 %ignore rankup::Format::get_count_at(int8_t const &);
 %ignore rankup::Format::operator std::string() const;
 
+// struct CardMapping is internal to Rules and RulesTables
+%ignore rankup::CardMapping;
+
 // class Composition
 %rename(equal) rankup::Composition::operator==;
 %ignore rankup::Composition::insert;
@@ -25,4 +29,5 @@
 %include "stdint.i"
 %include "common/definitions.hpp"
 %include "common/card.hpp"
-%include "rules/rules.hpp"
\ No newline at end of file
+%include "rules/rules.hpp"
+%include "rules/hand_structure.hpp"
\ No newline at end of file
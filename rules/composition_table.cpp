@@ -0,0 +1,56 @@
+#include "rules/composition_table.hpp"
+
+#include <stdexcept>
+
+#include "profile/stats.hpp"
+
+namespace rankup {
+CompositionTable::CompositionTable(int8_t num_values)
+    : m_num_values(num_values) {
+  if (num_values != 12 and num_values != 13) {
+    RANKUP_STATS_COUNT(EXCEPTION);
+    throw std::runtime_error(
+        "CompositionTable only supports folk suits of 12 or 13 values!");
+  }
+
+  m_own_data.resize(POW3[num_values]);
+  m_data = m_own_data.data();
+  for (std::uint32_t index = 0; index < m_own_data.size(); ++index) {
+    // decode the base-3 digits into the same bitmasks as ValueCounts
+    std::uint32_t once = 0;
+    std::uint32_t twice = 0;
+    auto rest = index;
+    for (int8_t v = 0; v < num_values; ++v, rest /= 3) {
+      const auto digit = rest % 3;
+      if (digit >= 1) once |= 1u << v;
+      if (digit == 2) twice |= 1u << v;
+    }
+
+    auto& packed = m_own_data[index];
+    packed.num_components = 0;
+    packed.components.fill(0);
+    auto push = [&packed](int8_t axle, int8_t start) {
+      packed.components[packed.num_components++] =
+          PackedComposition::pack(axle, start);
+    };
+
+    // same as RulesImpl::insert_components without minor lords
+    auto pairs = twice;
+    auto singles = once & ~twice;
+    while (pairs) {
+      const int8_t start = __builtin_ctz(pairs);
+      push(__builtin_ctz(~(pairs >> start)), start);
+      pairs &= pairs + (1u << start);
+    }
+    while (singles) {
+      push(0, __builtin_ctz(singles));
+      singles &= singles - 1;
+    }
+  }
+}
+
+int8_t CompositionTable::num_folk_values(const Rules& rules) {
+  // all ranks but the lord rank, unless the lord card is a joker
+  return rules.lord_card().rank() < Rank::_w ? 12 : 13;
+}
+}  // namespace rankup
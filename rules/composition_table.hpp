@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "common/definitions.hpp"
+#include "rules/rules.hpp"
+
+namespace rankup {
+
+/**
+   Compositions of a folk suit, packed into 16 bytes. A folk suit has at most
+   13 distinct values, so it has at most 13 components.
+ */
+struct PackedComposition {
+  std::uint8_t num_components;
+  // each component packs its axle in the upper 4 bits and its start in the
+  // lower 4 bits
+  std::array<std::uint8_t, 15> components;
+
+  static std::uint8_t pack(int8_t axle, int8_t start) {
+    return (axle << 4) | start;
+  }
+  static int8_t axle_of(std::uint8_t component) { return component >> 4; }
+  static int8_t start_of(std::uint8_t component) { return component & 0xf; }
+};
+static_assert(sizeof(PackedComposition) == 16);
+
+/**
+   Precomputed compositions of every multiset of cards of a folk suit. A folk
+   suit has 12 distinct values when there is a lord rank and 13 otherwise,
+   each held 0, 1 or 2 times, so a multiset is indexed by the base-3 number
+   whose digit v is the number of copies of value v. The values, as opposed to
+   the ranks, are used so that one table serves all lord cards with the same
+   number of folk values.
+ */
+class CompositionTable {
+ public:
+  /**
+     Build the table, which takes 3^num_values entries.
+
+     @throw std::runtime_error if num_values is neither 12 nor 13.
+   */
+  explicit CompositionTable(int8_t num_values);
+
+  CompositionTable(const CompositionTable&) = delete;
+  CompositionTable& operator=(const CompositionTable&) = delete;
+
+  int8_t num_values() const { return m_num_values; }
+
+  std::size_t size() const { return POW3[m_num_values]; }
+
+  const PackedComposition& at(std::uint32_t index) const {
+    assert(index < size());
+    return m_data[index];
+  }
+
+  const PackedComposition* data() const { return m_data; }
+
+  /**
+     @return 3^value, the contribution of one copy of value to an index
+   */
+  static std::uint32_t weight(int8_t value) { return POW3[value]; }
+
+  /**
+     @return the number of distinct values of a folk suit under `rules`
+   */
+  static int8_t num_folk_values(const Rules& rules);
+
+ private:
+  // large enough for any major() of a Value
+  inline static constexpr std::array<std::uint32_t, 16> POW3 = {
+      1,      3,       9,       27,      81,       243,      729,     2187,
+      6561,   19683,   59049,   177147,  531441,   1594323,  4782969, 14348907};
+
+  int8_t m_num_values;
+  // points to either m_own_data or entries owned by RulesTables
+  const PackedComposition* m_data;
+  std::vector<PackedComposition> m_own_data;
+
+  /**
+     A table viewing `data` that is owned elsewhere.
+   */
+  CompositionTable(int8_t num_values, const PackedComposition* data)
+      : m_num_values(num_values), m_data(data) {}
+
+  friend class RulesTables;
+};
+
+}  // namespace rankup
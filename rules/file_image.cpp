@@ -0,0 +1,84 @@
+#include "rules/file_image.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "profile/stats.hpp"
+
+namespace rankup {
+namespace {
+[[noreturn]] void fail(const std::string& msg) {
+  RANKUP_STATS_COUNT(EXCEPTION);
+  throw std::runtime_error(msg);
+}
+}  // namespace
+
+std::uint64_t file_image_checksum(const void* data, std::size_t size) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  std::uint64_t hash = 14695981039346656037ull;
+  for (std::size_t i = 0; i + 8 <= size; i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes + i, 8);
+    hash = (hash ^ word) * 1099511628211ull;
+  }
+  return hash;
+}
+
+std::shared_ptr<unsigned char> allocate_file_image(std::size_t size) {
+  auto words =
+      std::make_shared<std::vector<std::uint64_t>>((size + 7) / 8);
+  return {words, reinterpret_cast<unsigned char*>(words->data())};
+}
+
+std::shared_ptr<const void> map_file_image(const std::string& path,
+                                           const char (&magic)[8],
+                                           std::uint32_t version,
+                                           std::size_t header_size,
+                                           bool verify_checksum,
+                                           const std::string& who) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) fail(who + " cannot open " + path);
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 or
+      static_cast<std::size_t>(st.st_size) < header_size) {
+    ::close(fd);
+    fail(who + " found no header in " + path);
+  }
+  const std::size_t size = st.st_size;
+
+  void* addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) fail(who + " cannot map " + path);
+  std::shared_ptr<const void> image(
+      addr, [size](const void* p) { ::munmap(const_cast<void*>(p), size); });
+
+  FileImageHeader header;
+  std::memcpy(&header, addr, sizeof(FileImageHeader));
+  if (std::memcmp(header.magic, magic, sizeof(header.magic)) != 0)
+    fail(who + " found a wrong magic in " + path);
+  if (header.version != version)
+    fail(who + " found an unsupported version in " + path);
+  if (header.size != size) fail(who + " found a wrong size in " + path);
+  if (verify_checksum and
+      header.checksum !=
+          file_image_checksum(static_cast<const char*>(addr) + header_size,
+                              size - header_size))
+    fail(who + " found a wrong checksum in " + path);
+  return image;
+}
+
+void write_file_image(const void* image, std::size_t size,
+                      const std::string& path, const std::string& who) {
+  std::ofstream out(path, std::ios::binary);
+  out.write(static_cast<const char*>(image), size);
+  if (!out) fail(who + " failed writing " + path);
+}
+}  // namespace rankup
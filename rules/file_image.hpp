@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace rankup {
+/**
+   The fields common to the headers of the binary files written once and
+   memory-mapped read-only by every process, i.e. those of RulesTables and
+   EndgameTablebase. The header of every such file starts with these fields,
+   and the rest of the header and the payload are up to each format.
+ */
+struct FileImageHeader {
+  char magic[8];
+  std::uint32_t version;
+  // free for each format
+  std::uint32_t format_data;
+  // the size of the whole file
+  std::uint64_t size;
+  // checksum of everything after the header
+  std::uint64_t checksum;
+};
+
+// @return whether Header starts with the fields of FileImageHeader
+template <class Header>
+constexpr bool starts_with_file_image_header() {
+  return offsetof(Header, magic) == offsetof(FileImageHeader, magic) and
+         offsetof(Header, version) == offsetof(FileImageHeader, version) and
+         offsetof(Header, size) == offsetof(FileImageHeader, size) and
+         offsetof(Header, checksum) == offsetof(FileImageHeader, checksum);
+}
+
+/**
+   FNV-1a over 64-bit words, ignoring a trailing partial word. The sizes of
+   file images are always multiples of 8.
+ */
+std::uint64_t file_image_checksum(const void* data, std::size_t size);
+
+/**
+   @return a zeroed image of size bytes, aligned on 64-bit words
+ */
+std::shared_ptr<unsigned char> allocate_file_image(std::size_t size);
+
+/**
+   Memory-map the file at path read-only and check its common header
+   fields. who names the caller in the messages of errors.
+
+   @param header_size, the size of the whole header of the format
+   @param verify_checksum, whether to check the integrity of the whole file,
+   which reads every page of it
+
+   @return the mapped image, unmapped when the last owner releases it
+
+   @throw std::runtime_error if the file cannot be mapped, or if it has a
+   wrong magic, version, size or checksum.
+ */
+std::shared_ptr<const void> map_file_image(const std::string& path,
+                                           const char (&magic)[8],
+                                           std::uint32_t version,
+                                           std::size_t header_size,
+                                           bool verify_checksum,
+                                           const std::string& who);
+
+/**
+   Write the size bytes of image to path.
+
+   @throw std::runtime_error if the file cannot be written.
+ */
+void write_file_image(const void* image, std::size_t size,
+                      const std::string& path, const std::string& who);
+}  // namespace rankup
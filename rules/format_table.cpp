@@ -0,0 +1,211 @@
+#include "rules/format_table.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <stdexcept>
+
+#include "profile/stats.hpp"
+
+namespace rankup {
+namespace {
+// a max-heap of axles without allocation. A format of at most 127 cards has
+// at most 127 axles.
+class AxleHeap {
+ public:
+  explicit AxleHeap(const std::vector<int8_t>& sorted_axles)
+      : m_size(sorted_axles.size()) {
+    // an array sorted from high to low is already a max-heap
+    std::copy(sorted_axles.begin(), sorted_axles.end(), m_data.begin());
+  }
+
+  bool empty() const { return m_size == 0; }
+
+  int8_t pop() {
+    std::pop_heap(m_data.begin(), m_data.begin() + m_size);
+    return m_data[--m_size];
+  }
+
+  void push(int8_t axle) {
+    m_data[m_size++] = axle;
+    std::push_heap(m_data.begin(), m_data.begin() + m_size);
+  }
+
+ private:
+  std::array<int8_t, 128> m_data;
+  int m_size;
+};
+
+int total_num_cards(const std::vector<int8_t>& axles) {
+  int res = 0;
+  for (auto axle : axles) res += axle == 0 ? 1 : 2 * axle;
+  return res;
+}
+
+// the same algorithm as Format::is_covered_by
+bool covered_by(const std::vector<int8_t>& a, const std::vector<int8_t>& b) {
+  if (total_num_cards(b) < total_num_cards(a)) return false;
+
+  AxleHeap pq_a(a);
+  AxleHeap pq_b(b);
+  while (!pq_a.empty() and !pq_b.empty()) {
+    auto ax_a = pq_a.pop();
+    auto ax_b = pq_b.pop();
+    if (ax_a < ax_b) {
+      pq_b.push(ax_b - ax_a);
+    } else if (ax_a > ax_b) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// the same algorithm as Format::extract_required_format_from, with the result
+// written to res to reuse its storage
+void extract(const std::vector<int8_t>& a, const std::vector<int8_t>& b,
+             std::vector<int8_t>& res) {
+  res.clear();
+  AxleHeap pq_a(a);
+  AxleHeap pq_b(b);
+  while (!pq_a.empty() and !pq_b.empty()) {
+    auto ax_a = pq_a.pop();
+    auto ax_b = pq_b.pop();
+    if (ax_a < ax_b) {
+      res.push_back(ax_a);
+      pq_b.push(ax_b - ax_a);
+    } else if (ax_b == 0) {
+      res.push_back(ax_b);
+      for (int c = 1; c < 2 * ax_a; ++c) pq_a.push(0);
+    } else if (ax_a > ax_b) {
+      res.push_back(ax_b);
+      pq_a.push(ax_a - ax_b);
+    } else {
+      res.push_back(ax_a);
+    }
+  }
+  std::sort(res.begin(), res.end(), std::greater<int8_t>());
+}
+}  // namespace
+
+FormatTable::FormatTable(int8_t max_num_cards)
+    : m_max_num_cards(max_num_cards), m_max_axle(max_num_cards / 2) {
+  m_num.assign(max_num_cards + 1,
+               std::vector<std::uint32_t>(m_max_axle + 1, 0));
+  for (int n = 0; n <= max_num_cards; ++n) {
+    m_num[n][0] = 1;
+    for (int a = 1; a <= m_max_axle; ++a) {
+      for (int r = n; r >= 0; r -= num_cards_of(a))
+        m_num[n][a] += m_num[r][a - 1];
+    }
+  }
+
+  m_offset.resize(max_num_cards + 1);
+  std::uint32_t num_formats = 0;
+  for (int n = 0; n <= max_num_cards; ++n) {
+    m_offset[n] = num_formats;
+    num_formats += m_num[n][m_max_axle];
+  }
+  if (num_formats >= INVALID_ID) {
+    RANKUP_STATS_COUNT(EXCEPTION);
+    throw std::runtime_error("FormatTable has too many formats to index!");
+  }
+
+  // enumerate formats in the order of their ids, i.e. by the number of cards
+  // and then by the counts of axles from high to low
+  std::vector<int8_t> axles;
+  std::function<void(int, int)> enumerate = [&](int rest, int a) {
+    if (a == 0) {
+      axles.insert(axles.end(), rest, 0);
+      m_axles.push_back(axles);
+      axles.resize(axles.size() - rest);
+      return;
+    }
+    for (int k = 0; k * num_cards_of(a) <= rest; ++k) {
+      enumerate(rest - k * num_cards_of(a), a - 1);
+      axles.push_back(a);
+    }
+    axles.resize(axles.size() - (rest / num_cards_of(a) + 1));
+  };
+  for (int n = 0; n <= max_num_cards; ++n) enumerate(n, m_max_axle);
+
+  m_covered_by.resize(num_formats * num_formats);
+  m_extract.resize(num_formats * num_formats);
+  for (std::size_t i = 0; i < num_formats; ++i) {
+    assert(id_of_axles(m_axles[i]) == i);
+    for (std::size_t j = 0; j < num_formats; ++j) {
+      m_covered_by[i * num_formats + j] = covered_by(m_axles[i], m_axles[j]);
+      extract(m_axles[i], m_axles[j], axles);
+      m_extract[i * num_formats + j] = id_of_axles(axles);
+    }
+  }
+}
+
+FormatId FormatTable::id_of_axles(
+    const std::vector<int8_t>& sorted_axles) const {
+  const int n = total_num_cards(sorted_axles);
+  if (n > m_max_num_cards) return INVALID_ID;
+
+  // count the formats of n cards that come before this one
+  std::uint32_t rank = 0;
+  int rest = n;
+  auto it = sorted_axles.begin();
+  for (int a = m_max_axle; a > 0; --a) {
+    for (; it != sorted_axles.end() and *it == a; ++it) {
+      rank += m_num[rest][a - 1];
+      rest -= num_cards_of(a);
+    }
+  }
+  return m_offset[n] + rank;
+}
+
+FormatId FormatTable::id_of(const Format& format) const {
+  const int n = format.total_num_cards();
+  if (n > m_max_num_cards) return INVALID_ID;
+
+  std::uint32_t rank = 0;
+  int rest = n;
+  for (int a = m_max_axle; a > 0; --a) {
+    for (int k = format.get_count_at_or_0(a); k > 0; --k) {
+      rank += m_num[rest][a - 1];
+      rest -= num_cards_of(a);
+    }
+  }
+  return m_offset[n] + rank;
+}
+
+Format FormatTable::format_of(FormatId id, Suit suit) const {
+  Format res(suit);
+  for (auto axle : m_axles[id]) res.insert(axle);
+  return res;
+}
+
+bool FormatTable::is_covered_by(const Format& format,
+                                const Format& other) const {
+  if (!format.suit())
+    return true;
+  else if (!other.suit())
+    return false;
+
+  if (*other.suit() != *format.suit() and *other.suit() != Suit::J)
+    return false;
+
+  const auto id = id_of(format);
+  const auto id_o = id_of(other);
+  if (id == INVALID_ID or id_o == INVALID_ID)
+    return format.is_covered_by(other);
+  return is_covered_by(id, id_o);
+}
+
+Format FormatTable::extract_required_format_from(const Format& format,
+                                                 const Format& other) const {
+  if (!format.suit() or !other.suit()) return {};
+  if (*other.suit() != *format.suit()) return {};
+
+  const auto id = id_of(format);
+  const auto id_o = id_of(other);
+  if (id == INVALID_ID or id_o == INVALID_ID)
+    return format.extract_required_format_from(other);
+  return format_of(extract_required_format_from(id, id_o), *format.suit());
+}
+}  // namespace rankup
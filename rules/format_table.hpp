@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/definitions.hpp"
+#include "rules/rules.hpp"
+
+namespace rankup {
+
+using FormatId = std::uint16_t;
+
+/**
+   Interned axle structures of all formats up to a maximum number of cards,
+   together with precomputed results of Format::is_covered_by and
+   Format::extract_required_format_from between any two of them.
+
+   An id only captures the axles of a format, not its suit, which the methods
+   taking Formats handle the same way as the Format methods do. Ids are ranked
+   combinatorially, so finding the id of a format needs neither sorting nor
+   hashing.
+ */
+class FormatTable {
+ public:
+  // the number of cards of a player in a game of four players and two decks
+  inline static constexpr int8_t MAX_HAND_SIZE = 25;
+
+  inline static constexpr FormatId INVALID_ID = 0xffff;
+
+  /**
+     Build the tables, which is quadratic in the number of formats, e.g. 1780
+     formats for 25 cards.
+
+     @throw std::runtime_error if there are too many formats for FormatId.
+   */
+  explicit FormatTable(int8_t max_num_cards = MAX_HAND_SIZE);
+
+  int8_t max_num_cards() const { return m_max_num_cards; }
+
+  std::size_t size() const { return m_axles.size(); }
+
+  /**
+     @return the id of the axles of format, or INVALID_ID if format has more
+     than max_num_cards cards.
+   */
+  FormatId id_of(const Format& format) const;
+
+  /**
+     @return the format with the axles of id and the given suit
+   */
+  Format format_of(FormatId id, Suit suit) const;
+
+  /**
+     The axle part of Format::is_covered_by, including the comparison of the
+     total number of cards.
+   */
+  bool is_covered_by(FormatId id, FormatId other) const {
+    return m_covered_by[id * size() + other];
+  }
+
+  /**
+     The axle part of Format::extract_required_format_from.
+   */
+  FormatId extract_required_format_from(FormatId id, FormatId other) const {
+    return m_extract[id * size() + other];
+  }
+
+  /**
+     Same as format.is_covered_by(other), falling back to it for formats out
+     of range.
+   */
+  bool is_covered_by(const Format& format, const Format& other) const;
+
+  /**
+     Same as format.extract_required_format_from(other), falling back to it
+     for formats out of range.
+   */
+  Format extract_required_format_from(const Format& format,
+                                      const Format& other) const;
+
+ private:
+  int8_t m_max_num_cards;
+  int8_t m_max_axle;
+
+  // m_num[n][a] is the number of formats of n cards with axles no higher
+  // than a
+  std::vector<std::vector<std::uint32_t>> m_num;
+  // m_offset[n] is the id of the first format of n cards
+  std::vector<FormatId> m_offset;
+
+  // axles of each format, sorted from high to low
+  std::vector<std::vector<int8_t>> m_axles;
+
+  std::vector<bool> m_covered_by;
+  std::vector<FormatId> m_extract;
+
+  static int8_t num_cards_of(int8_t axle) { return axle == 0 ? 1 : 2 * axle; }
+
+  FormatId id_of_axles(const std::vector<int8_t>& sorted_axles) const;
+};
+
+}  // namespace rankup
@@ -0,0 +1,22 @@
+// Generate the file of precomputed RulesTables, to be memory-mapped with
+// RulesTables::load.
+
+#include <exception>
+#include <iostream>
+
+#include "rules/rules_tables.hpp"
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <output file>" << std::endl;
+    return 1;
+  }
+
+  try {
+    rankup::RulesTables::build()->write(argv[1]);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
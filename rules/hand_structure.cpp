@@ -0,0 +1,79 @@
+#include "rules/hand_structure.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "profile/stats.hpp"
+#include "rules_impl.hpp"
+
+namespace rankup {
+HandStructure::HandStructure(const Rules& rules, const std::vector<Card>& hand)
+    : m_rules(&rules) {
+  const auto& mapping = *rules.m_mapping;
+
+  for (const auto& card : hand) {
+    const auto suit = static_cast<int>(mapping.lorded_suit[card.index()]);
+    m_cards[suit].push_back(card);
+    m_counts[suit].add(evaluate(mapping, card));
+  }
+
+  m_cmp.reserve(NUM_LORDED_SUITS);
+  for (int suit = 0; suit < NUM_LORDED_SUITS; ++suit) {
+    m_cmp.emplace_back(static_cast<Suit>(suit));
+    rebuild(suit);
+  }
+}
+
+void HandStructure::rebuild(int suit) {
+  auto& cmp = m_cmp[suit];
+  cmp = Composition(static_cast<Suit>(suit));
+  if (m_counts[suit].empty()) return;
+
+  // same as EnhancedComposition::direct_append_extra()
+  for (auto start : m_rules->m_impl->insert_components(m_counts[suit], cmp)) {
+    cmp.insert(1, start);
+  }
+}
+
+void HandStructure::remove(const std::vector<Card>& cards) {
+  const auto& mapping = *m_rules->m_mapping;
+
+  int affected = 0;  // bit array of lorded suits
+  for (auto i = 0u; i < cards.size(); ++i) {
+    const auto& card = cards[i];
+    const auto suit = static_cast<int>(mapping.lorded_suit[card.index()]);
+    auto& held = m_cards[suit];
+    auto it = std::find(held.begin(), held.end(), card);
+    if (it == held.end()) {
+      // roll back what has been removed so far
+      restore({cards.begin(), cards.begin() + i});
+      RANKUP_STATS_COUNT(EXCEPTION);
+      throw std::runtime_error(
+          "HandStructure::remove called with cards not in the hand!");
+    }
+    held.erase(it);
+    m_counts[suit].remove(evaluate(mapping, card));
+    affected |= 1 << suit;
+  }
+
+  for (int suit = 0; suit < NUM_LORDED_SUITS; ++suit) {
+    if (affected & (1 << suit)) rebuild(suit);
+  }
+}
+
+void HandStructure::restore(const std::vector<Card>& cards) {
+  const auto& mapping = *m_rules->m_mapping;
+
+  int affected = 0;  // bit array of lorded suits
+  for (const auto& card : cards) {
+    const auto suit = static_cast<int>(mapping.lorded_suit[card.index()]);
+    m_cards[suit].push_back(card);
+    m_counts[suit].add(evaluate(mapping, card));
+    affected |= 1 << suit;
+  }
+
+  for (int suit = 0; suit < NUM_LORDED_SUITS; ++suit) {
+    if (affected & (1 << suit)) rebuild(suit);
+  }
+}
+}  // namespace rankup
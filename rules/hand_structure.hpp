@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/definitions.hpp"
+#include "rules/rules.hpp"
+#include "rules/value.hpp"
+
+namespace rankup {
+
+/**
+   The structure of an entire hand under some Rules. The hand is split into
+   the four folk suits and the lords, the latter denoted by Suit::J, and each
+   of the five lorded suits is parsed into a Composition. All of this is done
+   in a single pass over the hand.
+
+   Cards can then be removed from and restored to the hand, as happens during
+   a game or a make/unmake search. Per-suit bitmask counts are maintained
+   along the way, so that only the compositions of the affected lorded suits
+   are rebuilt, directly from the bitmasks.
+ */
+class HandStructure {
+ public:
+  HandStructure(const Rules& rules, const std::vector<Card>& hand);
+
+  /**
+     @param suit, a lorded suit, i.e. Suit::J for lords
+     @return all cards of `suit` in the hand. Restored cards are appended.
+   */
+  const std::vector<Card>& cards(Suit suit) const {
+    return m_cards[static_cast<int>(suit)];
+  }
+
+  /**
+     @param suit, a lorded suit, i.e. Suit::J for lords
+
+     @return the composition of all cards of `suit` in the hand. Any extra
+     pairs of minor lords are resolved with direct_append_extra(), which keeps
+     the number of pairs. The composition is empty if the hand has no cards of
+     `suit`.
+   */
+  const Composition& composition(Suit suit) const {
+    return m_cmp[static_cast<int>(suit)];
+  }
+
+  /**
+     Remove `cards`, e.g. those just played, from the hand.
+
+     @throw std::runtime_error if the hand doesn't have all of `cards`, in
+     which case the hand is left unchanged.
+   */
+  void remove(const std::vector<Card>& cards);
+
+  /**
+     Add `cards` back to the hand, e.g. to undo `remove(cards)`.
+   */
+  void restore(const std::vector<Card>& cards);
+
+ private:
+  const Rules* m_rules;
+
+  std::array<std::vector<Card>, NUM_LORDED_SUITS> m_cards;
+  std::array<ValueCounts, NUM_LORDED_SUITS> m_counts;
+  std::vector<Composition> m_cmp;
+
+  void rebuild(int suit);
+};
+
+}  // namespace rankup
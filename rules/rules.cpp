@@ -2,32 +2,51 @@
 
 #include <algorithm>
 #include <cstdint>
-#include <limits>
 #include <queue>  // priority_queue
 #include <sstream>
 #include <stdexcept>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 #include "common/definitions.hpp"
+#include "common/hash.hpp"
+#include "profile/stats.hpp"
+#include "profile/trace.hpp"
+#include "rules/composition_table.hpp"
+#include "rules/format_table.hpp"
+#include "rules/hand_structure.hpp"
+#include "rules/rules_tables.hpp"
 #include "rules_impl.hpp"
 
 namespace rankup {
+namespace {
+// tags of the terms summed up by Format::hash and Composition::hash, without
+// which e.g. a suit and a single would have the same term.
+constexpr std::uint64_t HASH_TAG_SUIT = std::uint64_t(1) << 32;
+constexpr std::uint64_t HASH_TAG_AXLE = std::uint64_t(2) << 32;
+}  // namespace
+
 int Format::get_index(const int8_t& axle) const noexcept {
   auto it = std::find(m_axle.begin(), m_axle.end(), axle);
   return it != m_axle.end() ? std::distance(m_axle.begin(), it) : INVALID_INDEX;
 }
 
 int Format::get_index_highest_axle() const {
-  if (m_axle.empty())
+  if (m_axle.empty()) {
+    RANKUP_STATS_COUNT(EXCEPTION);
     throw std::runtime_error(
         "No cards exist when calling get_index_highest_axle");
+  }
   auto it = std::max_element(m_axle.begin(), m_axle.end());
   return std::distance(m_axle.begin(), it);
 }
 
 int8_t Format::insert(int8_t axle) {
-  if (!m_suit)
+  if (!m_suit) {
+    RANKUP_STATS_COUNT(EXCEPTION);
     throw std::runtime_error("Format::insert called in an empty format!");
+  }
 
   auto idx = get_index(axle);
   if (idx != INVALID_INDEX) {
@@ -45,6 +64,7 @@ const int8_t& Format::get_count_at(const int8_t& axle) const {
   if (idx == INVALID_INDEX) {
     std::string msg = "Axle " + std::to_string(static_cast<int>(axle)) +
                       " not found in the format!";
+    RANKUP_STATS_COUNT(EXCEPTION);
     throw std::out_of_range(msg);
   }
   return m_count[idx];
@@ -143,6 +163,11 @@ Format Format::extract_required_format_from(const Format& other) const {
     if (ax_a < ax_b) {
       res.insert(ax_a);
       pq_b.push(ax_b - ax_a);
+    } else if (ax_b == 0) {
+      // other has only singles left, each taking one card of the component
+      // of this format, whose other cards are then demanded as singles
+      res.insert(ax_b);
+      for (int c = 1; c < 2 * ax_a; ++c) pq_a.push(0);
     } else if (ax_a > ax_b) {
       res.insert(ax_b);
       pq_a.push(ax_a - ax_b);
@@ -169,6 +194,18 @@ bool Format::operator==(const Format& other) const {
   return true;
 }
 
+std::uint64_t Format::hash() const noexcept {
+  if (!suit()) return 0;
+  // summing makes the hash independent of the order of m_axle. Terms are
+  // tagged so that a suit never hashes the same as an axle.
+  std::uint64_t res = mix64(HASH_TAG_SUIT | static_cast<std::uint8_t>(*suit()));
+  for (auto i = 0u; i < m_axle.size(); ++i) {
+    res += mix64(HASH_TAG_AXLE | (static_cast<std::uint64_t>(m_axle[i]) << 8) |
+                 static_cast<std::uint8_t>(m_count[i]));
+  }
+  return res;
+}
+
 Format::operator std::string() const {
   std::ostringstream ss;
   if (!suit()) {
@@ -219,6 +256,7 @@ int8_t Composition::insert(int8_t axle, int8_t start) {
 
 bool Composition::defeats(const Composition& other) const {
   if (total_num_cards() != other.total_num_cards()) {
+    RANKUP_STATS_COUNT(EXCEPTION);
     throw std::runtime_error(
         "Composition::defeats called with mismatched total number of cards!");
   }
@@ -256,6 +294,7 @@ bool Composition::defeats(const Composition& other) const {
 
 std::unordered_map<int8_t, std::vector<int8_t>> Composition::get_start_map()
     const {
+  RANKUP_STATS_TIMER(GET_START_MAP);
   std::unordered_map<int8_t, std::vector<int8_t>> res;
   for (auto i = 0u; i < m_axle.size(); ++i) {
     res[m_axle[i]] = m_start[i].data();
@@ -282,6 +321,20 @@ bool Composition::operator==(const Composition& other) const {
   return true;
 }
 
+std::uint64_t Composition::hash() const noexcept {
+  // summing makes the hash independent of the order of m_axle and starts.
+  // Unlike xor, it keeps repeated components such as two minor lord pairs.
+  std::uint64_t res = mix64(HASH_TAG_SUIT | static_cast<std::uint8_t>(suit()));
+  for (auto i = 0u; i < m_axle.size(); ++i) {
+    for (auto start : m_start[i].data()) {
+      res += mix64(HASH_TAG_AXLE |
+                   (static_cast<std::uint64_t>(m_axle[i]) << 8) |
+                   static_cast<std::uint8_t>(start));
+    }
+  }
+  return res;
+}
+
 Composition::operator std::string() const {
   std::ostringstream ss;
   ss << "Suit " << static_cast<int>(suit()) << ", ";
@@ -301,16 +354,18 @@ Composition::operator std::string() const {
 
 namespace rankup {
 Format RoundRules::get_required_format(const std::vector<Card>& hand) const {
+  RANKUP_TRACE_SCOPE("RoundRules::get_required_format");
   // TOLDO assert(m_fmt has suit and m_fmt.total_num_cards > 0). This should be
   // guaranteed once RoundRules is created.
 
   std::vector<Card> cards;
   {
-    // extract all cards with the given suit
+    // extract all cards with the given suit. NOTE lords must be told apart by
+    // the rules, since e.g. a lord-rank card of a folk suit is a lord.
     // TOLDO can we make it lazy?
     std::copy_if(hand.begin(), hand.end(), std::back_inserter(cards),
-                 [suit_given = *m_fmt.suit()](const auto& card) {
-                   return card.suit() == suit_given;
+                 [this, suit_given = *m_fmt.suit()](const auto& card) {
+                   return m_rules.lorded_suit(card) == suit_given;
                  });
   }
   if (cards.empty()) return {};
@@ -318,18 +373,54 @@ Format RoundRules::get_required_format(const std::vector<Card>& hand) const {
   auto enh_cmp = *(m_rules.parse_for_single_suit(cards));
 
   if (enh_cmp.empty_minor_lord_pairs()) {
-    return m_fmt.extract_required_format_from(enh_cmp.cmp.format());
+    return extract_required_format_from(enh_cmp.cmp.format());
   } else {
     // CLAIM: m_fmt is played by the first player, so it's impossible that m_fmt
     // has mixed axles if it is lord. In this case, one should just use
     // direct_append_extra
-    return m_fmt.extract_required_format_from(
+    return extract_required_format_from(
         enh_cmp.direct_append_extra().format());
   }
 }
 
+Format RoundRules::get_required_format(const HandStructure& hand) const {
+  RANKUP_TRACE_SCOPE("RoundRules::get_required_format");
+  const auto suit = *m_fmt.suit();
+  if (hand.cards(suit).empty()) return {};
+
+  // minor lord pairs are already resolved with direct_append_extra() by
+  // HandStructure, same as above
+  return extract_required_format_from(hand.composition(suit).format());
+}
+
+Format RoundRules::extract_required_format_from(const Format& hand_fmt) const {
+  if (m_rules.m_format_table) {
+    return m_rules.m_format_table->extract_required_format_from(m_fmt,
+                                                                hand_fmt);
+  }
+  return m_fmt.extract_required_format_from(hand_fmt);
+}
+
+std::uint64_t RoundRules::hash() const noexcept {
+  // mixing the format hash tells it apart from a composition hash with the
+  // same terms
+  return mix64(m_fmt.hash()) ^ m_winning_cmp.hash();
+}
+
+RoundRules RoundRules::relabeled(const std::array<Suit, 5>& to) const {
+  // cards of folk suits have the same values in every folk suit, so only the
+  // suits change
+  Format fmt = m_fmt;
+  fmt.relabel(to[static_cast<int>(*fmt.suit())]);
+  Composition cmp = m_winning_cmp;
+  cmp.relabel(to[static_cast<int>(cmp.suit())]);
+  return RoundRules(m_rules, std::move(fmt), std::move(cmp));
+}
+
 bool RoundRules::update_if_defeated_by(const std::vector<Card>& cards) {
+  RANKUP_TRACE_SCOPE("RoundRules::update_if_defeated_by");
   if (cards.size() != m_winning_cmp.total_num_cards()) {
+    RANKUP_STATS_COUNT(EXCEPTION);
     throw std::runtime_error(
         "RoundRules::update_if_defeated_by called with mismatched total number "
         "of cards!");
@@ -367,10 +458,17 @@ std::string Rules::check_valid_as_first_cards(
   // TODO implement
 }
 
+Suit Rules::lorded_suit(const Card& card) const {
+  // Here we use Suit::J to represent all lords
+  return m_mapping->lorded_suit[card.index()];
+}
+
 RoundRules Rules::start_round_with(const std::vector<Card>& cards) const {
+  RANKUP_TRACE_SCOPE("Rules::start_round_with");
   auto enh_cmp_opt = parse_for_single_suit(cards);
 
   if (!enh_cmp_opt) {
+    RANKUP_STATS_COUNT(EXCEPTION);
     throw std::runtime_error(
         "Rules::start_round_with called with cards of non-uniform suit!");
   }
@@ -383,6 +481,90 @@ RoundRules Rules::start_round_with(const std::vector<Card>& cards) const {
 
   return RoundRules(*this, std::move(cmp));
 }
+
+std::vector<Card> Rules::check_throw(
+    const std::vector<Card>& cards,
+    const std::vector<std::vector<Card>>& others) const {
+  RANKUP_TRACE_SCOPE("Rules::check_throw");
+  auto enh_cmp_opt = parse_for_single_suit(cards);
+  if (!enh_cmp_opt) {
+    RANKUP_STATS_COUNT(EXCEPTION);
+    throw std::runtime_error(
+        "Rules::check_throw called with cards of non-uniform suit!");
+  }
+  // resolved the same way as in start_round_with
+  const Composition cmp = enh_cmp_opt->empty_minor_lord_pairs()
+                              ? enh_cmp_opt->cmp
+                              : enh_cmp_opt->direct_append_extra();
+  const Suit suit = cmp.suit();
+
+  // the components of the other hands in suit, each hand parsed the same way
+  // as a lead so that pairs of minor lords join tractors only as the rules
+  // allow
+  std::vector<std::pair<int8_t, int8_t>> components;
+  std::vector<Card> suited;
+  for (const auto& hand : others) {
+    suited.clear();
+    for (const auto& card : hand)
+      if (m_mapping->lorded_suit[card.index()] == suit) suited.push_back(card);
+    if (suited.empty()) continue;
+    const auto enh_other = parse_for_single_suit(suited);
+    enh_other->cmp.for_each_component([&components](int8_t axle, int8_t start) {
+      components.emplace_back(axle, start);
+    });
+    for (auto start : enh_other->extra_ml_pair_start)
+      components.emplace_back(1, start);
+  }
+
+  // whether a component of another hand beats the component of axle at
+  // start, a tractor also holding the shorter runs of its pairs
+  auto beaten = [&components](int8_t axle, int8_t start) {
+    for (const auto& [ax, st] : components) {
+      if (axle == 0 ? st + std::max<int8_t>(ax, 1) - 1 > start
+                    : ax >= axle and st + ax - axle > start)
+        return true;
+    }
+    return false;
+  };
+
+  // the smallest, then weakest, failing component
+  int num_components = 0;
+  int8_t failed_axle = -1;
+  int8_t failed_start = 0;
+  cmp.for_each_component([&](int8_t axle, int8_t start) {
+    ++num_components;
+    if (!beaten(axle, start)) return;
+    if (failed_axle < 0 or axle < failed_axle or
+        (axle == failed_axle and start < failed_start)) {
+      failed_axle = axle;
+      failed_start = start;
+    }
+  });
+  if (num_components <= 1 or failed_axle < 0) return {};
+
+  // the cards of the failing component
+  std::array<int8_t, NUM_CARD_KINDS> counts{};
+  for (const auto& card : cards) ++counts[card.index()];
+  auto major_of = [this](int8_t i) { return m_mapping->value[i] >> 3; };
+  std::vector<Card> res;
+  if (failed_axle == 0) {
+    for (int8_t i = 0; i < NUM_CARD_KINDS and res.empty(); ++i)
+      if (counts[i] == 1 and major_of(i) == failed_start)
+        res.push_back(Card::from_index(i));
+    return res;
+  }
+  for (int8_t major = failed_start; major < failed_start + failed_axle;
+       ++major) {
+    for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+      if (counts[i] == 2 and major_of(i) == major) {
+        res.insert(res.end(), 2, Card::from_index(i));
+        counts[i] = 0;
+        break;
+      }
+    }
+  }
+  return res;
+}
 }  // namespace rankup
 
 namespace rankup {
@@ -401,6 +583,7 @@ Composition Rules::EnhancedComposition::split_merge_extra() const {
 
   if (extra_ml_pair_start.empty()) return cmp;
 
+  RANKUP_STATS_TIMER(SPLIT_MERGE_EXTRA);
   Composition res(cmp.suit());
 
   const auto ml_start = extra_ml_pair_start[0];
@@ -434,7 +617,8 @@ Composition Rules::EnhancedComposition::split_merge_extra() const {
   return res;
 }
 
-Rules::Rules(Card lord_card) : m_lord_card(std::move(lord_card)) {
+namespace {
+std::unique_ptr<Rules::RulesImpl> make_impl(const Card& lord_card) {
   // Three cases of lordedness
   //
   // 1. lord.rank != wW, lord.suit != J
@@ -443,149 +627,104 @@ Rules::Rules(Card lord_card) : m_lord_card(std::move(lord_card)) {
   //
   // 3. lord.rank == wW, lord.suit == J
 
-  if (m_lord_card.rank() < Rank::_w) {
-    if (m_lord_card.suit() != Suit::J) {
-      m_impl.reset(new RulesLordful(m_lord_card));
+  if (lord_card.rank() < Rank::_w) {
+    if (lord_card.suit() != Suit::J) {
+      return std::make_unique<RulesLordful>(lord_card);
     } else {
-      m_impl.reset(new RulesLordlessOverthrown(m_lord_card));
+      return std::make_unique<RulesLordlessOverthrown>(lord_card);
     }
   } else {
-    m_impl.reset(new RulesLordlessRegular(m_lord_card));
+    return std::make_unique<RulesLordlessRegular>(lord_card);
+  }
+}
+}  // namespace
+
+Rules::Rules(Card lord_card)
+    : m_lord_card(std::move(lord_card)), m_impl(make_impl(m_lord_card)) {
+  for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+    const auto card = Card::from_index(i);
+    m_own_mapping.value[i] = m_impl->evaluate(card).full();
+    m_own_mapping.lorded_suit[i] =
+        m_impl->is_lord(card) ? Suit::J : card.suit();
   }
 }
 
-Rules::~Rules() = default;
+Rules::Rules(Card lord_card, std::shared_ptr<const RulesTables> tables)
+    : m_lord_card(std::move(lord_card)),
+      m_impl(make_impl(m_lord_card)),
+      m_mapping(&tables->mapping(m_lord_card)),
+      m_tables(tables),
+      m_table(tables->composition_table(
+          CompositionTable::num_folk_values(*this))) {}
 
-namespace parse_impl {
-/**
-   @param cards, guaranteed to have size > 0
- */
-std::tuple<bool, Suit, std::vector<Value>> construct_sorted_values(
-    const std::vector<Card>& cards, const Rules::RulesImpl& impl) {
-  bool single_suit = true;
-  Suit suit;
-  std::vector<Value> values;
-  values.reserve(cards.size());
-
-  auto lorded_suit = [&impl](const Card& card) {
-    // Here we use Suit::J to represent all lords
-    return impl.is_lord(card) ? Suit::J : card.suit();
-  };
+Rules::~Rules() = default;
 
-  suit = lorded_suit(cards[0]);
-  values.push_back(impl.evaluate(cards[0]));
-  for (auto i = 1u; i < cards.size(); ++i) {
-    if (lorded_suit(cards[i]) != suit) {
-      single_suit = false;
-      break;
-    }
-    values.push_back(impl.evaluate(cards[i]));
-  }
+void Rules::use_format_table(std::shared_ptr<const FormatTable> table) {
+  m_format_table = std::move(table);
+}
 
-  if (single_suit) {
-    std::sort(values.begin(), values.end());
+void Rules::use_composition_table(
+    std::shared_ptr<const CompositionTable> table) {
+  if (table and
+      table->num_values() != CompositionTable::num_folk_values(*this)) {
+    RANKUP_STATS_COUNT(EXCEPTION);
+    throw std::runtime_error(
+        "Rules::use_composition_table called with a mismatched table!");
   }
-
-  return {single_suit, suit, values};
+  m_table = std::move(table);
 }
 
-struct Component {
-  Component() = default;
-  Component(int8_t a, int8_t s) : axle(a), start(s) {}
-
-  int8_t axle;
-  int8_t start;
-};
-
+namespace parse_impl {
 /**
-   @param values, values are sorted, free of complications due to minor lords.
+   @param cards, guaranteed to have size > 0
  */
-std::vector<Component> parse_to_components(const std::vector<Value>& values) {
-  std::vector<Component> res;
-  if (values.empty()) return res;
-
-  // define two modes for parsing.
-  constexpr bool FOR_EQUAL = false;
-  constexpr bool FOR_ADJ = true;
-
-  // NOTE in storing the m_start of a Component, we store Value::major() as
-  // opposed to full().
-
-  Value val_last = values[0];
-  int8_t axle = 0;
-  bool mode = FOR_EQUAL;
-
-  auto parse_in_equal_mode = [&val_last, &axle, &mode, &res](const Value& val) {
-    // in comparing equal for a pair, we must compare full().
-    if (val.full() == val_last.full()) {
-      ++axle;
-      mode = FOR_ADJ;
-    } else {
-      // fail to pair.
-      if (axle != 0) {
-        res.emplace_back(axle, val_last.major() - axle);
-      }
-      res.emplace_back(0, val_last.major());
-      val_last = val;
-      axle = 0;  // reset
-    }
-  };
-
-  auto parse_in_adj_mode = [&val_last, &axle, &mode, &res](const Value& val) {
-    //  in comparing adj, we must compare major().
-    if (val.major() == val_last.major() + 1) {
-      val_last = val;
-      mode = FOR_EQUAL;
-    } else {
-      res.emplace_back(axle, val_last.major() - axle + 1);
-      val_last = val;
-      axle = 0;
-      mode = FOR_EQUAL;
-    }
-  };
-
-  // append a sentinel to `values` to make sure the last element in
-  // `values` is stored.
-  const Value sentinel(std::numeric_limits<int8_t>::max());
-  for (auto i = 1u; i <= values.size(); ++i) {
-    const auto& val = i != values.size() ? values[i] : sentinel;
-    if (mode == FOR_EQUAL)
-      parse_in_equal_mode(val);
-    else
-      parse_in_adj_mode(val);
+std::tuple<bool, Suit, ValueCounts, std::optional<std::uint32_t>>
+construct_value_counts(const std::vector<Card>& cards,
+                       const CardMapping& mapping) {
+  ValueCounts counts;
+  // index into a CompositionTable, only meaningful for folk suits, and
+  // nullopt once a value has more copies than the table's 2
+  std::optional<std::uint32_t> index = 0;
+  const Suit suit = mapping.lorded_suit[cards[0].index()];
+  for (const auto& card : cards) {
+    if (mapping.lorded_suit[card.index()] != suit)
+      return {false, suit, counts, index};
+    const auto val = evaluate(mapping, card);
+    if (!val.is_minor_lord() and (counts.twice >> val.major() & 1))
+      index.reset();
+    counts.add(val);
+    if (index) *index += CompositionTable::weight(val.major());
   }
 
-  return res;
+  return {true, suit, counts, index};
 }
-
 }  // namespace parse_impl
 
 std::optional<Rules::EnhancedComposition> Rules::parse_for_single_suit(
     const std::vector<Card>& cards) const {
+  RANKUP_TRACE_SCOPE("Rules::parse_for_single_suit");
   // TOLDO is this necessary
   if (cards.size() == 0) {
+    RANKUP_STATS_COUNT(EXCEPTION);
     throw std::runtime_error("Parsing empty cards is forbidden!");
   }
   std::optional<Rules::EnhancedComposition> enh_cmp;
 
-  auto [is_single_suit, suit, values] =
-      parse_impl::construct_sorted_values(cards, *m_impl);
+  auto [is_single_suit, suit, counts, index] =
+      parse_impl::construct_value_counts(cards, *m_mapping);
   if (!is_single_suit) return enh_cmp;
 
-  auto extra_minor_lord_pairs = m_impl->adjust_for_minor_lords(values);
-
   Composition cmp(suit);
-  for (const auto& [axle, start] : parse_impl::parse_to_components(values)) {
-    cmp.insert(axle, start);
-  }
-
-  auto minor_lord_comps =
-      parse_impl::parse_to_components(extra_minor_lord_pairs);
   std::vector<int8_t> ml_pairs;
-  ml_pairs.reserve(minor_lord_comps.size());
-  for (const auto& [axle, start] : minor_lord_comps) {
-    assert(axle == 1);
-    ml_pairs.push_back(start);
+  if (m_table and suit != Suit::J and index) {
+    const auto& packed = m_table->at(*index);
+    for (int i = 0; i < packed.num_components; ++i) {
+      const auto component = packed.components[i];
+      cmp.insert(PackedComposition::axle_of(component),
+                 PackedComposition::start_of(component));
+    }
+  } else {
+    ml_pairs = m_impl->insert_components(counts, cmp);
   }
 
   enh_cmp.emplace(std::move(cmp), std::move(ml_pairs));
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -42,6 +43,12 @@ class Format {
 
   const std::optional<Suit>& suit() const { return m_suit; }
 
+  /**
+     Change the suit of a format that has one, e.g. to relabel folk suits,
+     which are interchangeable.
+   */
+  void relabel(Suit suit) { m_suit = suit; }
+
   /**
      @return the total number of cards this format represents.
    */
@@ -59,6 +66,12 @@ class Format {
 
   bool operator==(const Format& other) const;
 
+  /**
+     @return a hash that is independent of the order in which axles were
+     inserted, so that formats equal by operator== have equal hashes.
+   */
+  std::uint64_t hash() const noexcept;
+
   explicit operator std::string() const;
 
  protected:
@@ -114,6 +127,17 @@ class Composition : private Format {
 
   Suit suit() const { return *format().suit(); }
 
+  using Format::relabel;
+
+  /**
+     Call f(axle, start) for every component, without allocating.
+   */
+  template <typename F>
+  void for_each_component(F&& f) const {
+    for (std::size_t i = 0; i < m_axle.size(); ++i)
+      for (const auto start : m_start[i].data()) f(m_axle[i], start);
+  }
+
   int8_t total_num_cards() const { return format().total_num_cards(); }
 
   /**
@@ -134,6 +158,12 @@ class Composition : private Format {
 
   bool operator==(const Composition& other) const;
 
+  /**
+     @return a hash that is independent of the order of insertion, so that
+     compositions equal by operator== have equal hashes.
+   */
+  std::uint64_t hash() const noexcept;
+
   explicit operator std::string() const;
 
  private:
@@ -164,6 +194,21 @@ OStream& operator<<(OStream& o, const Composition& cmp) {
 }
 
 class Rules;
+class HandStructure;
+class CompositionTable;
+class FormatTable;
+class RulesTables;
+
+/**
+   What Rules makes of each card of a deck, indexed by Card::index(). It is a
+   plain block of bytes so that it can be stored in RulesTables.
+ */
+struct CardMapping {
+  // Value::full() of each card
+  std::array<int8_t, NUM_CARD_KINDS> value;
+  // lorded suit of each card
+  std::array<Suit, NUM_CARD_KINDS> lorded_suit;
+};
 
 /**
    RoundRules enforces rules when a Composition is specified.
@@ -182,6 +227,11 @@ class RoundRules {
    */
   Format get_required_format(const std::vector<Card>& hand) const;
 
+  /**
+     Same as above, but reads the already parsed structure of the hand.
+   */
+  Format get_required_format(const HandStructure& hand) const;
+
   /**
      @return true if the current composition is defeated by cards, and false
      otherwise.
@@ -190,18 +240,59 @@ class RoundRules {
    */
   bool update_if_defeated_by(const std::vector<Card>& cards);
 
+  /**
+     @return the format of the first cards of the round
+   */
+  const Format& format() const { return m_fmt; }
+
+  /**
+     @return the composition currently winning the round
+   */
+  const Composition& winning_composition() const { return m_winning_cmp; }
+
+  /**
+     @return a hash of the trick state, i.e. the format of the first cards
+     together with the currently winning composition.
+   */
+  std::uint64_t hash() const noexcept;
+
+  /**
+     @param to, the suit taking the place of each suit, indexed by Suit. It
+     must map Suit::J, and the suit of the lord card of the rules, to
+     themselves.
+
+     @return the round with the suits of its format and winning composition
+     relabeled by `to`
+   */
+  RoundRules relabeled(const std::array<Suit, 5>& to) const;
+
  private:
+  RoundRules(const Rules& rules, Format fmt, Composition cmp)
+      : m_rules(rules), m_fmt(std::move(fmt)), m_winning_cmp(std::move(cmp)) {}
+
   const Rules& m_rules;
   const Format m_fmt;
   // NOTE m_winning_cmp may have a different suit than the original format, but
   // must have the same components.
   Composition m_winning_cmp;
+
+  /**
+     @return m_fmt.extract_required_format_from(hand_fmt), read from the
+     format table of m_rules if there is one.
+   */
+  Format extract_required_format_from(const Format& hand_fmt) const;
 };
 
 class Rules {
  public:
   explicit Rules(Card lord_card);
 
+  /**
+     Construct the rules reading the card mapping and the composition tables
+     of folk suits from precomputed `tables`.
+   */
+  Rules(Card lord_card, std::shared_ptr<const RulesTables> tables);
+
   ~Rules();
 
   /**
@@ -222,9 +313,64 @@ class Rules {
    */
   RoundRules start_round_with(const std::vector<Card>& cards) const;
 
+  /**
+     Check a throw, i.e. first cards of several components of one suit,
+     against the hands of the other players. A component fails if a hand has
+     a stronger component of the same shape in the suit. Each hand is parsed
+     into its components in the suit once, the way a lead of it would be,
+     rather than enumerating its subsets, so that pairs of minor lords join
+     tractors only as the rules allow.
+
+     @param others, the entire cards of each other player
+
+     @return the cards of the smallest failing component, the weakest among
+     the smallest, which is to be played instead of the throw, or empty if
+     the throw stands. Cards of a single component always stand.
+
+     @throw std::runtime_error if cards is empty or doesn't have a uniform
+     suit.
+   */
+  std::vector<Card> check_throw(
+      const std::vector<Card>& cards,
+      const std::vector<std::vector<Card>>& others) const;
+
+  /**
+     @return the suit of card, or Suit::J if card is a lord
+   */
+  Suit lorded_suit(const Card& card) const;
+
+  /**
+     @return the strength of card within its lorded suit, i.e. the major
+     value. A stronger card beats a weaker one, and pairs of adjacent
+     strengths make a tractor. Minor lords of different suits have the same
+     strength.
+   */
+  int8_t strength(const Card& card) const {
+    return m_mapping->value[card.index()] >> 3;
+  }
+
+  const Card& lord_card() const { return m_lord_card; }
+
+  /**
+     Look up compositions of folk suits in `table` instead of parsing them.
+     Passing nullptr reverts to parsing.
+
+     @throw std::runtime_error if table has a different number of folk values
+     than these rules.
+   */
+  void use_composition_table(std::shared_ptr<const CompositionTable> table);
+
+  /**
+     Look up the required formats of RoundRules in `table` instead of
+     computing them. Passing nullptr reverts to computing.
+   */
+  void use_format_table(std::shared_ptr<const FormatTable> table);
+
   struct RulesImpl;
 
   friend class RoundRules;
+  friend class HandStructure;
+  friend class RulesTables;
   friend class TestRules;
 
  private:
@@ -232,6 +378,14 @@ class Rules {
 
   std::unique_ptr<RulesImpl> m_impl;
 
+  // m_mapping points to either m_own_mapping or an entry of m_tables
+  CardMapping m_own_mapping;
+  const CardMapping* m_mapping = &m_own_mapping;
+  std::shared_ptr<const RulesTables> m_tables;
+
+  std::shared_ptr<const CompositionTable> m_table;
+  std::shared_ptr<const FormatTable> m_format_table;
+
   // keyed by Format::m_axle, and the vector of each axle is sorted from low to
   // high
   std::vector<std::vector<int8_t>> m_start;
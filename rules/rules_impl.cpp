@@ -3,6 +3,8 @@
 #include <array>
 #include <algorithm>
 
+#include "profile/stats.hpp"
+
 namespace rankup {
 
 std::vector<Value> Rules::RulesImpl::adjust_for_minor_lords(
@@ -108,6 +110,65 @@ std::vector<Value> Rules::RulesImpl::adjust_for_minor_lords(
   return res;
 }
 
+std::vector<int8_t> Rules::RulesImpl::insert_components(
+    const ValueCounts& counts, Composition& cmp, const int8_t minor_lord_val,
+    bool allow_adjacent_pair_to_the_left_of_minor_lords) {
+  std::vector<int8_t> res;
+
+  std::uint32_t pairs = counts.twice;
+  std::uint32_t singles = counts.once & ~counts.twice;
+
+  int8_t num_minor_pairs = 0;
+  int8_t num_minor_singles = 0;
+  for (auto c : counts.minor) {
+    if (c == 2)
+      ++num_minor_pairs;
+    else if (c == 1)
+      ++num_minor_singles;
+  }
+
+  if (num_minor_pairs > 0) {
+    // Exactly one pair of minor lords takes the place of minor_lord_val in
+    // the pair mask, through which it can join tractors on either side.
+    const std::uint32_t bit = 1u << minor_lord_val;
+    const bool has_pair_of_one_less =
+        allow_adjacent_pair_to_the_left_of_minor_lords and (pairs & (bit >> 1));
+    const bool has_pair_of_major_lords = pairs & (bit << 1);
+    pairs |= bit;
+
+    if (has_pair_of_one_less and has_pair_of_major_lords) {
+      RANKUP_STATS_COUNT(MINOR_LORD_EXTRACT);
+      // the remaining pairs can't be represented in cmp
+      res.assign(num_minor_pairs - 1, minor_lord_val);
+    } else {
+      if (has_pair_of_major_lords)
+        RANKUP_STATS_COUNT(MINOR_LORD_SHIFT_RIGHT);
+      else if (has_pair_of_one_less)
+        RANKUP_STATS_COUNT(MINOR_LORD_SHIFT_LEFT);
+      for (int8_t i = 1; i < num_minor_pairs; ++i)
+        cmp.insert(1, minor_lord_val);
+    }
+  }
+
+  for (int8_t i = 0; i < num_minor_singles; ++i) cmp.insert(0, minor_lord_val);
+
+  // each run of consecutive bits in pairs is a tractor
+  while (pairs) {
+    const int8_t start = __builtin_ctz(pairs);
+    const int8_t axle = __builtin_ctz(~(pairs >> start));
+    cmp.insert(axle, start);
+    // adding the lowest bit carries through, and thus clears, the lowest run
+    pairs &= pairs + (1u << start);
+  }
+
+  while (singles) {
+    cmp.insert(0, __builtin_ctz(singles));
+    singles &= singles - 1;
+  }
+
+  return res;
+}
+
 Value RulesLordful::evaluate(const Card& card) const {
   static_assert(static_cast<int8_t>(Rank::_2) == 0);
   int8_t rank = static_cast<int8_t>(card.rank());
@@ -136,6 +197,11 @@ std::vector<Value> RulesLordful::adjust_for_minor_lords(
                                                   true);
 }
 
+std::vector<int8_t> RulesLordful::insert_components(
+    const ValueCounts& counts, Composition& cmp) const {
+  return Rules::RulesImpl::insert_components(counts, cmp, MINOR_LORD_VAL, true);
+}
+
 Value RulesLordlessOverthrown::evaluate(const Card& card) const {
   static_assert(static_cast<int8_t>(Rank::_2) == 0);
   int8_t rank = static_cast<int8_t>(card.rank());
@@ -161,6 +227,12 @@ std::vector<Value> RulesLordlessOverthrown::adjust_for_minor_lords(
                                                   false);
 }
 
+std::vector<int8_t> RulesLordlessOverthrown::insert_components(
+    const ValueCounts& counts, Composition& cmp) const {
+  return Rules::RulesImpl::insert_components(counts, cmp, MINOR_LORD_VAL,
+                                             false);
+}
+
 Value RulesLordlessRegular::evaluate(const Card& card) const {
   static_assert(static_cast<int8_t>(Rank::_2) == 0);
   int8_t rank = static_cast<int8_t>(card.rank());
@@ -2,43 +2,11 @@
 #include <cassert>
 
 #include "rules.hpp"
+#include "value.hpp"
 
 namespace rankup {
-class Value {
- public:
-  // not made explicit to facilitate test writing.
-  Value(int8_t value, bool is_minor_lord = false,
-        Suit minor_lord_suit = Suit::D) {
-    m_data = (value << 3);
-    if (is_minor_lord) {
-      assert(minor_lord_suit != Suit::J);
-      m_data += (static_cast<int8_t>(minor_lord_suit) << 1) + 1;
-    }
-  }
-
-  int8_t full() const { return m_data; }
-
-  int8_t major() const { return m_data >> 3; }
-
-  int8_t minor() const { return (m_data >> 1) & 3; }
-
-  bool is_minor_lord() const { return m_data & 1; }
-
-  bool operator<(const Value& other) const { return full() < other.full(); }
-
-  bool operator==(const Value& other) const { return full() == other.full(); }
-
- private:
-  int8_t m_data;
-};
-
-template <typename OStream>
-OStream& operator<<(OStream& o, const Value& val) {
-  o << static_cast<int>(val.major());
-  if (val.is_minor_lord()) {
-    o << "." << static_cast<int>(val.minor());
-  }
-  return o;
+inline Value evaluate(const CardMapping& mapping, const Card& card) {
+  return Value::from_full(mapping.value[card.index()]);
 }
 
 struct Rules::RulesImpl {
@@ -56,12 +24,25 @@ struct Rules::RulesImpl {
   virtual std::vector<Value> adjust_for_minor_lords(
       std::vector<Value>& sorted_values) const = 0;
 
+  /**
+   * Insert into `cmp` all components of `counts`, resolving minor lords the
+   * same way as adjust_for_minor_lords followed by a sequential parse does.
+   *
+   * @return starts of any pair of additional minor lords
+   */
+  virtual std::vector<int8_t> insert_components(const ValueCounts& counts,
+                                                Composition& cmp) const = 0;
+
  protected:
   Card m_lord;
 
   static std::vector<Value> adjust_for_minor_lords(
       std::vector<Value>& sorted_values, const int8_t minor_lord_val,
       bool allow_adjacent_pair_to_the_left_of_minor_lords);
+
+  static std::vector<int8_t> insert_components(
+      const ValueCounts& counts, Composition& cmp, const int8_t minor_lord_val,
+      bool allow_adjacent_pair_to_the_left_of_minor_lords);
 };
 
 /**
@@ -74,6 +55,8 @@ class RulesLordful : public Rules::RulesImpl {
   bool is_lord(const Card& card) const override;
   std::vector<Value> adjust_for_minor_lords(
       std::vector<Value>& sorted_values) const override;
+  std::vector<int8_t> insert_components(const ValueCounts& counts,
+                                        Composition& cmp) const override;
 
  private:
   static constexpr int8_t MINOR_LORD_VAL = 12;
@@ -89,6 +72,8 @@ class RulesLordlessOverthrown : public Rules::RulesImpl {
   bool is_lord(const Card& card) const override;
   std::vector<Value> adjust_for_minor_lords(
       std::vector<Value>& sorted_values) const override;
+  std::vector<int8_t> insert_components(const ValueCounts& counts,
+                                        Composition& cmp) const override;
 
  private:
   static constexpr int8_t MINOR_LORD_VAL = 12;
@@ -107,6 +92,11 @@ class RulesLordlessRegular : public Rules::RulesImpl {
     // no actions
     return {};
   }
+  std::vector<int8_t> insert_components(const ValueCounts& counts,
+                                        Composition& cmp) const override {
+    // there are no minor lords, so the minor lord value is irrelevant
+    return Rules::RulesImpl::insert_components(counts, cmp, 0, false);
+  }
 };
 
 }  // namespace rankup
\ No newline at end of file
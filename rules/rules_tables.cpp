@@ -0,0 +1,127 @@
+#include "rules/rules_tables.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "profile/stats.hpp"
+#include "rules/file_image.hpp"
+
+namespace rankup {
+namespace {
+constexpr char MAGIC[8] = {'R', 'A', 'N', 'K', 'U', 'P', 'T', 'B'};
+
+constexpr std::uint64_t ALIGNMENT = 64;
+
+constexpr std::uint64_t align_up(std::uint64_t offset) {
+  return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+int lord_slot(const Card& lord_card) {
+  return static_cast<int>(lord_card.suit()) * 15 +
+         static_cast<int>(lord_card.rank());
+}
+
+[[noreturn]] void fail(const std::string& msg) {
+  RANKUP_STATS_COUNT(EXCEPTION);
+  throw std::runtime_error(msg);
+}
+}  // namespace
+
+std::shared_ptr<const RulesTables> RulesTables::build() {
+  const CompositionTable table_12(12);
+  const CompositionTable table_13(13);
+
+  Header header = {};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.num_lord_cards = NUM_LORD_CARDS;
+  header.mappings_offset = align_up(sizeof(Header));
+  header.tables_offset[0] =
+      align_up(header.mappings_offset + NUM_LORD_CARDS * sizeof(CardMapping));
+  header.tables_offset[1] = align_up(
+      header.tables_offset[0] + table_12.size() * sizeof(PackedComposition));
+  header.size = align_up(header.tables_offset[1] +
+                         table_13.size() * sizeof(PackedComposition));
+
+  const auto owner = allocate_file_image(header.size);
+  auto* image = owner.get();
+
+  for (int suit = 0; suit < 5; ++suit) {
+    for (int rank = 0; rank < 15; ++rank) {
+      const Card lord_card(static_cast<Suit>(suit), static_cast<Rank>(rank));
+      const Rules rules(lord_card);
+      std::memcpy(image + header.mappings_offset +
+                      lord_slot(lord_card) * sizeof(CardMapping),
+                  &rules.m_own_mapping, sizeof(CardMapping));
+    }
+  }
+  std::memcpy(image + header.tables_offset[0], table_12.data(),
+              table_12.size() * sizeof(PackedComposition));
+  std::memcpy(image + header.tables_offset[1], table_13.data(),
+              table_13.size() * sizeof(PackedComposition));
+
+  header.checksum =
+      file_image_checksum(image + sizeof(Header), header.size - sizeof(Header));
+  std::memcpy(image, &header, sizeof(Header));
+
+  std::shared_ptr<RulesTables> res(new RulesTables);
+  res->attach(owner);
+  return res;
+}
+
+std::shared_ptr<const RulesTables> RulesTables::load(const std::string& path,
+                                                     bool verify_checksum) {
+  auto image = map_file_image(path, MAGIC, VERSION, sizeof(Header),
+                              verify_checksum, "RulesTables::load");
+  const auto* header = static_cast<const Header*>(image.get());
+  if (header->num_lord_cards != NUM_LORD_CARDS)
+    fail("RulesTables::load found a wrong size in " + path);
+
+  // the header is outside the checksum, so its offsets are checked against
+  // the size whether or not the checksum is verified
+  auto fits = [header](std::uint64_t offset, std::uint64_t num_bytes) {
+    return offset >= sizeof(Header) and offset % ALIGNMENT == 0 and
+           offset <= header->size and num_bytes <= header->size - offset;
+  };
+  if (!fits(header->mappings_offset, NUM_LORD_CARDS * sizeof(CardMapping)))
+    fail("RulesTables::load found a wrong offset in " + path);
+  for (int i = 0; i < 2; ++i) {
+    if (!fits(header->tables_offset[i],
+              CompositionTable::POW3[12 + i] * sizeof(PackedComposition)))
+      fail("RulesTables::load found a wrong offset in " + path);
+  }
+
+  std::shared_ptr<RulesTables> res(new RulesTables);
+  res->attach(std::move(image));
+  return res;
+}
+
+void RulesTables::attach(std::shared_ptr<const void> image) {
+  m_image = std::move(image);
+  const auto* bytes = static_cast<const unsigned char*>(m_image.get());
+  const auto& h = header();
+
+  m_mappings = reinterpret_cast<const CardMapping*>(bytes + h.mappings_offset);
+  for (int i = 0; i < 2; ++i) {
+    m_tables[i].reset(new CompositionTable(
+        12 + i, reinterpret_cast<const PackedComposition*>(
+                    bytes + h.tables_offset[i])));
+  }
+}
+
+void RulesTables::write(const std::string& path) const {
+  write_file_image(m_image.get(), header().size, path, "RulesTables::write");
+}
+
+const CardMapping& RulesTables::mapping(const Card& lord_card) const {
+  return m_mappings[lord_slot(lord_card)];
+}
+
+std::shared_ptr<const CompositionTable> RulesTables::composition_table(
+    int8_t num_values) const {
+  if (num_values != 12 and num_values != 13)
+    fail("RulesTables::composition_table supports only 12 or 13 values!");
+  // share ownership of this object, which owns the table
+  return {shared_from_this(), m_tables[num_values - 12].get()};
+}
+}  // namespace rankup
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common/card.hpp"
+#include "rules/composition_table.hpp"
+#include "rules/file_image.hpp"
+#include "rules/rules.hpp"
+
+namespace rankup {
+
+/**
+   Precomputed lookup tables for every lord card accepted by Rules: the
+   CardMapping of each lord card, as well as the CompositionTable of folk
+   suits with 12 and 13 values.
+
+   The tables can be generated once into a versioned, checksummed binary file
+   and memory-mapped read-only by every process, so that the pages are shared
+   among processes and nothing is rebuilt at startup. The file is in native
+   byte order.
+ */
+class RulesTables : public std::enable_shared_from_this<RulesTables> {
+ public:
+  inline static constexpr std::uint32_t VERSION = 1;
+
+  /**
+     Compute all tables in memory.
+   */
+  static std::shared_ptr<const RulesTables> build();
+
+  /**
+     Memory-map a file written by `write`.
+
+     @param verify_checksum, whether to check the integrity of the whole file,
+     which reads every page of it.
+
+     @throw std::runtime_error if the file cannot be mapped, or if it has a
+     wrong magic, version, size or checksum, or offsets out of the file.
+   */
+  static std::shared_ptr<const RulesTables> load(const std::string& path,
+                                                 bool verify_checksum = true);
+
+  /**
+     @throw std::runtime_error if the file cannot be written.
+   */
+  void write(const std::string& path) const;
+
+  /**
+     @return the mapping of cards under Rules(lord_card)
+   */
+  const CardMapping& mapping(const Card& lord_card) const;
+
+  /**
+     @param num_values, 12 or 13
+     @return the composition table, which shares ownership of this object
+   */
+  std::shared_ptr<const CompositionTable> composition_table(
+      int8_t num_values) const;
+
+ private:
+  // one entry per combination of suit and rank, as Rules accepts any of them
+  static constexpr int NUM_LORD_CARDS = 5 * 15;
+
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t num_lord_cards;
+    std::uint64_t size;
+    // checksum of everything after the header
+    std::uint64_t checksum;
+    std::uint64_t mappings_offset;
+    // offsets of composition tables of 12 and 13 values
+    std::array<std::uint64_t, 2> tables_offset;
+    std::uint64_t reserved;
+  };
+  static_assert(sizeof(Header) == 64);
+  static_assert(starts_with_file_image_header<Header>());
+
+  // the whole file image, either allocated or memory-mapped
+  std::shared_ptr<const void> m_image;
+  const CardMapping* m_mappings = nullptr;
+  std::array<std::unique_ptr<CompositionTable>, 2> m_tables;
+
+  RulesTables() = default;
+
+  const Header& header() const {
+    return *static_cast<const Header*>(m_image.get());
+  }
+
+  /**
+     Point the mappings and tables into m_image.
+   */
+  void attach(std::shared_ptr<const void> image);
+};
+
+}  // namespace rankup
@@ -0,0 +1,78 @@
+#include <catch2/catch.hpp>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "common/card.hpp"
+#include "rules/composition_table.hpp"
+#include "rules/rules.hpp"
+
+using namespace rankup;
+
+namespace rankup {
+class TestRules {
+ public:
+  static auto parse(const Rules& rules, const std::vector<Card>& cards) {
+    return rules.parse_for_single_suit(cards)->cmp;
+  }
+};
+}  // namespace rankup
+
+SCENARIO("CompositionTable", "[rules]") {
+  SECTION("only folk suits of 12 or 13 values are supported") {
+    CHECK_THROWS_AS(CompositionTable(11), std::runtime_error);
+  }
+
+  SECTION("packed compositions") {
+    const CompositionTable table(12);
+    REQUIRE(table.size() == 531441);
+
+    THEN("the empty multiset has no components") {
+      CHECK(table.at(0).num_components == 0);
+    }
+
+    THEN("pairs of adjacent values make a tractor") {
+      // 2 copies of values 3 and 4, 1 copy of value 7
+      const auto index = 2 * CompositionTable::weight(3) +
+                         2 * CompositionTable::weight(4) +
+                         CompositionTable::weight(7);
+      const auto& packed = table.at(index);
+      REQUIRE(packed.num_components == 2);
+      CHECK(packed.components[0] == PackedComposition::pack(2, 3));
+      CHECK(packed.components[1] == PackedComposition::pack(0, 7));
+    }
+  }
+
+  SECTION("Rules parse folk suits the same with or without a table") {
+    auto table_12 = std::make_shared<const CompositionTable>(12);
+    auto table_13 = std::make_shared<const CompositionTable>(13);
+
+    std::mt19937 gen(31);
+    std::uniform_int_distribution<int> num_copies(0, 2);
+    for (auto lord : {Card(Suit::S, Rank::_8), Card(Suit::J, Rank::_Q),
+                      Card(Suit::J, Rank::_W)}) {
+      Rules plain(lord);
+      Rules tabled(lord);
+      auto table =
+          CompositionTable::num_folk_values(tabled) == 12 ? table_12 : table_13;
+      CHECK_THROWS_AS(tabled.use_composition_table(
+                          table == table_12 ? table_13 : table_12),
+                      std::runtime_error);
+      tabled.use_composition_table(table);
+
+      for (int trial = 0; trial < 500; ++trial) {
+        std::vector<Card> cards;
+        for (int8_t r = 0; r < 13; ++r) {
+          const Card card(Suit::D, static_cast<Rank>(r));
+          if (plain.lorded_suit(card) != Suit::D) continue;
+          for (int n = num_copies(gen); n > 0; --n) cards.push_back(card);
+        }
+        if (cards.empty()) continue;
+
+        CHECK(TestRules::parse(plain, cards) ==
+              TestRules::parse(tabled, cards));
+      }
+    }
+  }
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "common/card.hpp"
+#include "rules/format_table.hpp"
+#include "rules/rules.hpp"
+
+using namespace rankup;
+
+SCENARIO("FormatTable", "[rules]") {
+  SECTION("too many formats to index") {
+    CHECK_THROWS_AS(FormatTable(60), std::runtime_error);
+  }
+
+  SECTION("ids") {
+    const FormatTable table(12);
+    // partitions of n into parts of sizes 1, 2, 4, 6, ...
+    REQUIRE(table.size() == 120);
+
+    THEN("ids and formats are inverse of each other") {
+      for (FormatId id = 0; id < table.size(); ++id) {
+        const auto fmt = table.format_of(id, Suit::H);
+        CHECK(fmt.suit() == Suit::H);
+        CHECK(table.id_of(fmt) == id);
+      }
+    }
+
+    THEN("ids are ordered by the number of cards") {
+      for (FormatId id = 1; id < table.size(); ++id) {
+        CHECK(table.format_of(id - 1, Suit::D).total_num_cards() <=
+              table.format_of(id, Suit::D).total_num_cards());
+      }
+    }
+
+    THEN("formats with too many cards are not interned") {
+      Format fmt(Suit::S);
+      fmt.insert(6);
+      fmt.insert(0);
+      CHECK(table.id_of(fmt) == FormatTable::INVALID_ID);
+    }
+  }
+
+  SECTION("tables agree with Format methods") {
+    const FormatTable table(12);
+    for (FormatId i = 0; i < table.size(); ++i) {
+      const auto a = table.format_of(i, Suit::C);
+      for (FormatId j = 0; j < table.size(); ++j) {
+        const auto b = table.format_of(j, Suit::C);
+        REQUIRE(table.is_covered_by(i, j) == a.is_covered_by(b));
+        REQUIRE(table.is_covered_by(a, b) == a.is_covered_by(b));
+        REQUIRE(table.is_covered_by(a, table.format_of(j, Suit::J)) ==
+                a.is_covered_by(table.format_of(j, Suit::J)));
+        REQUIRE_FALSE(table.is_covered_by(a, table.format_of(j, Suit::H)));
+        if (i != 0 and j != 0) {
+          REQUIRE(table.extract_required_format_from(a, b) ==
+                  a.extract_required_format_from(b));
+        }
+        REQUIRE(table.extract_required_format_from(
+                    a, table.format_of(j, Suit::H)) == Format());
+      }
+    }
+  }
+
+  SECTION("formats out of range fall back to Format methods") {
+    const FormatTable table(4);
+    Format a(Suit::S);
+    a.insert(1);
+    a.insert(0);
+    Format b(Suit::S);
+    b.insert(2);
+    b.insert(0);
+    b.insert(0);
+    CHECK(table.is_covered_by(a, b) == a.is_covered_by(b));
+    CHECK(table.extract_required_format_from(a, b) ==
+          a.extract_required_format_from(b));
+  }
+
+  SECTION("RoundRules with a format table") {
+    auto table = std::make_shared<const FormatTable>();
+    Rules rules(Card(Suit::S, Rank::_2));
+    Rules rules_with_table(Card(Suit::S, Rank::_2));
+    rules_with_table.use_format_table(table);
+
+    // a tractor of 3 and 4 of hearts, and a K of hearts
+    Composition first(Suit::H);
+    first.insert(2, 0);
+    first.insert(0, 10);
+    const std::vector<Card> hand = {
+        {Suit::H, Rank::_5}, {Suit::H, Rank::_5}, {Suit::H, Rank::_9},
+        {Suit::H, Rank::_J}, {Suit::H, Rank::_J}, {Suit::D, Rank::_A},
+        {Suit::S, Rank::_7}};
+
+    RoundRules round(rules, first);
+    RoundRules round_with_table(rules_with_table, first);
+    CHECK(round_with_table.get_required_format(hand) ==
+          round.get_required_format(hand));
+  }
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <vector>
+
+#include "common/card.hpp"
+#include "rules/hand_structure.hpp"
+#include "rules/rules.hpp"
+
+using namespace rankup;
+
+SCENARIO("HandStructure splits and parses a hand", "[rules]") {
+  const Rules rules(Card(Suit::S, Rank::_8));
+  const std::vector<Card> hand = {
+      {Suit::D, Rank::_4}, {Suit::S, Rank::_A}, {Suit::D, Rank::_5},
+      {Suit::D, Rank::_4}, {Suit::H, Rank::_8}, {Suit::D, Rank::_5},
+      {Suit::S, Rank::_A}, {Suit::H, Rank::_8}, {Suit::J, Rank::_W},
+      {Suit::C, Rank::_K}, {Suit::D, Rank::_8}, {Suit::D, Rank::_9}};
+  const HandStructure structure(rules, hand);
+
+  THEN("cards are split by lorded suit") {
+    CHECK(structure.cards(Suit::D).size() == 5);
+    CHECK(structure.cards(Suit::C).size() == 1);
+    CHECK(structure.cards(Suit::H).empty());
+    CHECK(structure.cards(Suit::S).empty());
+    CHECK(structure.cards(Suit::J).size() == 6);
+  }
+
+  THEN("each lorded suit is parsed") {
+    Composition d(Suit::D);
+    d.insert(2, 2);  // tractor 4 4 5 5
+    d.insert(0, 6);  // 9, one less since 8 is the lord rank
+    CHECK(structure.composition(Suit::D) == d);
+
+    Composition c(Suit::C);
+    c.insert(0, 10);
+    CHECK(structure.composition(Suit::C) == c);
+
+    // A A of the lord suit, minor lords 8H 8H, 8D, and the big joker
+    Composition j(Suit::J);
+    j.insert(2, 11);
+    j.insert(0, 12);
+    j.insert(0, 15);
+    CHECK(structure.composition(Suit::J) == j);
+
+    CHECK(structure.composition(Suit::H).total_num_cards() == 0);
+  }
+
+  THEN("get_required_format agrees with the one parsing the raw hand") {
+    for (const auto& lead : std::vector<std::vector<Card>>{
+             {{Suit::D, Rank::_6}, {Suit::D, Rank::_6}},
+             {{Suit::D, Rank::_J}},
+             {{Suit::H, Rank::_3}},
+             {{Suit::S, Rank::_3}, {Suit::S, Rank::_3}},
+             {{Suit::S, Rank::_3},
+              {Suit::S, Rank::_3},
+              {Suit::S, Rank::_4},
+              {Suit::S, Rank::_4}}}) {
+      const auto round = rules.start_round_with(lead);
+      const auto fmt = round.get_required_format(hand);
+      CAPTURE(fmt);
+      CHECK(fmt == round.get_required_format(structure));
+    }
+  }
+
+  THEN("lords of folk suits are followed as lords") {
+    const std::vector<Card> minor_lords = {
+        {Suit::H, Rank::_8}, {Suit::D, Rank::_4}, {Suit::H, Rank::_8}};
+    const auto round = rules.start_round_with(
+        {{Suit::S, Rank::_3}, {Suit::S, Rank::_3}});
+    Format fmt(Suit::J);
+    fmt.insert(1);
+    CHECK(round.get_required_format(minor_lords) == fmt);
+    CHECK(round.get_required_format(HandStructure(rules, minor_lords)) == fmt);
+  }
+}
+
+SCENARIO("HandStructure is updated as cards leave and return", "[rules]") {
+  const Rules rules(Card(Suit::S, Rank::_8));
+  const std::vector<Card> hand = {
+      {Suit::D, Rank::_4}, {Suit::D, Rank::_4}, {Suit::D, Rank::_5},
+      {Suit::D, Rank::_5}, {Suit::D, Rank::_6}, {Suit::D, Rank::_6},
+      {Suit::S, Rank::_A}, {Suit::S, Rank::_A}, {Suit::H, Rank::_8},
+      {Suit::H, Rank::_8}, {Suit::S, Rank::_8}, {Suit::S, Rank::_8},
+      {Suit::C, Rank::_K}, {Suit::J, Rank::_w}};
+
+  auto check_same = [](const HandStructure& a, const HandStructure& b) {
+    for (auto suit : {Suit::D, Suit::C, Suit::H, Suit::S, Suit::J}) {
+      CAPTURE(static_cast<int>(suit));
+      CHECK(a.composition(suit) == b.composition(suit));
+      CHECK(a.cards(suit).size() == b.cards(suit).size());
+    }
+  };
+
+  HandStructure structure(rules, hand);
+
+  for (const auto& played : std::vector<std::vector<Card>>{
+           {{Suit::D, Rank::_5}},
+           {{Suit::D, Rank::_5}, {Suit::D, Rank::_5}},
+           {{Suit::H, Rank::_8}, {Suit::C, Rank::_K}},
+           {{Suit::S, Rank::_A}, {Suit::S, Rank::_8}, {Suit::J, Rank::_w}}}) {
+    std::vector<Card> rest = hand;
+    for (const auto& card : played) {
+      rest.erase(std::find(rest.begin(), rest.end(), card));
+    }
+
+    structure.remove(played);
+    check_same(structure, HandStructure(rules, rest));
+
+    structure.restore(played);
+    check_same(structure, HandStructure(rules, hand));
+  }
+
+  WHEN("removing cards not in the hand") {
+    CHECK_THROWS_AS(
+        structure.remove({{Suit::D, Rank::_4}, {Suit::C, Rank::_2}}),
+        std::runtime_error);
+    THEN("the hand is unchanged") {
+      check_same(structure, HandStructure(rules, hand));
+    }
+  }
+}
@@ -1,5 +1,8 @@
 #include <catch2/catch.hpp>
+#include <algorithm>
 #include <cstdint>
+#include <limits>
+#include <random>
 #include <variant>
 
 #include "common/card.hpp"
@@ -398,6 +401,12 @@ class TestRules {
     return m_rules.m_impl->evaluate(card);
   }
 
+  bool is_lord(const Card& card) const { return m_rules.m_impl->is_lord(card); }
+
+  auto adjust_for_minor_lords(std::vector<Value>& sorted_values) const {
+    return m_rules.m_impl->adjust_for_minor_lords(sorted_values);
+  }
+
   const auto& lord_card() const { return m_rules.m_lord_card; }
 
   static auto make_enhanced_composition(Composition c,
@@ -535,6 +544,14 @@ SCENARIO("Format::extract_required_format_from", "[rules]") {
     CHECK(req_fmt == format.extract_required_format_from(other));
   }
 
+  SECTION("singles take the cards of pairs one by one") {
+    const auto format = gen_format(Suit::C, {2});
+    const auto other = gen_format(Suit::C, {1, 0, 0, 0, 0});
+    const auto req_fmt = gen_format(Suit::C, {1, 0, 0});
+    CHECK(req_fmt == format.extract_required_format_from(other));
+    CHECK(req_fmt.total_num_cards() == format.total_num_cards());
+  }
+
   SECTION("when other has fewer cards") {
     const auto format = gen_format(Suit::C, {2, 1, 1, 0, 0});
     {
@@ -768,7 +785,189 @@ SCENARIO("Rules::parse when Lordful", "[rules]") {
   }
 }
 
+namespace {
+// The sequential parser that Rules::parse_for_single_suit used before
+// switching to bitmasks. It serves as the reference implementation.
+std::vector<std::pair<int8_t, int8_t>> reference_parse_to_components(
+    const std::vector<Value>& values) {
+  std::vector<std::pair<int8_t, int8_t>> res;
+  if (values.empty()) return res;
+
+  Value val_last = values[0];
+  int8_t axle = 0;
+  bool for_adj = false;
+
+  const Value sentinel(std::numeric_limits<int8_t>::max());
+  for (auto i = 1u; i <= values.size(); ++i) {
+    const auto& val = i != values.size() ? values[i] : sentinel;
+    if (!for_adj) {
+      if (val.full() == val_last.full()) {
+        ++axle;
+        for_adj = true;
+      } else {
+        if (axle != 0) res.emplace_back(axle, val_last.major() - axle);
+        res.emplace_back(0, val_last.major());
+        val_last = val;
+        axle = 0;
+      }
+    } else {
+      if (val.major() != val_last.major() + 1) {
+        res.emplace_back(axle, val_last.major() - axle + 1);
+        axle = 0;
+      }
+      val_last = val;
+      for_adj = false;
+    }
+  }
+  return res;
+}
+}  // namespace
+
+SCENARIO("Rules::parse agrees with the sequential parser", "[rules]") {
+  std::mt19937 gen(2020);
+  for (auto lord : std::array<Card, 3>{Card(Suit::S, Rank::_8),
+                                       Card(Suit::J, Rank::_8),
+                                       Card(Suit::J, Rank::_W)}) {
+    TestRules rules(lord);
+    CAPTURE(static_cast<int>(lord.suit()), static_cast<int>(lord.rank()));
+
+    for (auto lorded_suit : std::array{Suit::D, Suit::S, Suit::J}) {
+      // all distinct cards of the lorded suit
+      std::vector<Card> pool;
+      for (int8_t s = 0; s < 5; ++s) {
+        for (int8_t r = 0; r < 15; ++r) {
+          const Card card(static_cast<Suit>(s), static_cast<Rank>(r));
+          if ((s == 4) != (r >= 13)) continue;
+          const Suit ls = rules.is_lord(card) ? Suit::J : card.suit();
+          if (ls == lorded_suit) pool.push_back(card);
+        }
+      }
+      if (pool.empty()) continue;
+
+      std::uniform_int_distribution<int> num_copies(0, 2);
+      for (int trial = 0; trial < 2000; ++trial) {
+        std::vector<Card> cards;
+        // bias toward pairs to exercise tractors and minor lords
+        for (const auto& card : pool) {
+          const int n = std::max(num_copies(gen), num_copies(gen));
+          for (int i = 0; i < n; ++i) cards.push_back(card);
+        }
+        if (cards.empty()) continue;
+        std::shuffle(cards.begin(), cards.end(), gen);
+
+        std::vector<Value> values;
+        for (const auto& card : cards) values.push_back(rules.evaluate(card));
+        std::sort(values.begin(), values.end());
+        const auto extra = rules.adjust_for_minor_lords(values);
+
+        Composition cmp_exp(lorded_suit);
+        for (auto [axle, start] : reference_parse_to_components(values))
+          cmp_exp.insert(axle, start);
+        std::vector<int8_t> extra_exp;
+        for (auto [axle, start] : reference_parse_to_components(extra))
+          extra_exp.push_back(start);
+
+        auto enh_cmp = rules.parse(cards);
+        REQUIRE(enh_cmp);
+        CAPTURE(cmp_exp, enh_cmp->cmp);
+        CHECK(enh_cmp->cmp == cmp_exp);
+        CHECK(enh_cmp->extra_ml_pair_start == extra_exp);
+      }
+    }
+  }
+}
+
 SCENARIO("Rules::start_round_with", "[rules]") {
   // TODO
 }
+
+SCENARIO("Rules::check_throw", "[rules]") {
+  const Rules rules(Card(Suit::S, Rank::_2));
+  const TestRules test_rules(Card(Suit::S, Rank::_2));
+  using C = std::vector<Card>;
+  const Card HA(Suit::H, Rank::_A), HK(Suit::H, Rank::_K),
+      HQ(Suit::H, Rank::_Q), HJ(Suit::H, Rank::_J), H10(Suit::H, Rank::_10),
+      H5(Suit::H, Rank::_5),
+      H3(Suit::H, Rank::_3), S3(Suit::S, Rank::_3);
+
+  // a failing component comes back whole, as a single component
+  auto check = [&](const C& cards, const std::vector<C>& others) {
+    const auto res = rules.check_throw(cards, others);
+    if (!res.empty()) {
+      const auto enh_cmp = test_rules.parse(res);
+      REQUIRE(enh_cmp);
+      CHECK(enh_cmp->cmp.format().total_num_cards() == res.size());
+      int num_components = 0;
+      enh_cmp->cmp.for_each_component([&](int8_t, int8_t) {
+        ++num_components;
+      });
+      CHECK(num_components == 1);
+    }
+    return res;
+  };
+
+  WHEN("no other hand beats a component") {
+    CHECK(check({HA, HK, HK}, {{HA, H3}, {HQ, HQ}, {S3}}).empty());
+  }
+  WHEN("trumps don't count") {
+    CHECK(check({HA, HK}, {{S3, S3}, {}, {}}).empty());
+  }
+  WHEN("a single component is led") {
+    CHECK(check({HQ, HQ}, {{HA, HA}}).empty());
+  }
+  WHEN("a single is beaten") {
+    CHECK(check({HK, HQ, HQ}, {{HA}, {H3}}) == C{HK});
+  }
+  WHEN("several components are beaten") {
+    // the single is the smallest
+    CHECK(check({HK, HQ, HQ}, {{H3}, {HA, HA}}) == C{HK});
+    // the pair is smaller than the tractor
+    CHECK(check({HQ, HQ, HJ, HJ, H3, H3}, {{HK, HK, HA, HA}}) ==
+          C{H3, H3});
+    CHECK(check({HQ, HQ, HJ, HJ, H3, H3}, {{H5, H5}}) == C{H3, H3});
+  }
+  WHEN("a tractor is beaten") {
+    CHECK(check({HJ, HJ, H10, H10, HA}, {{HK, HK, HQ, HQ}}) ==
+          C{H10, H10, HJ, HJ});
+  }
+  WHEN("the cards have several suits") {
+    REQUIRE_THROWS_AS(rules.check_throw({HA, S3}, {}), std::runtime_error);
+  }
+}
+
+SCENARIO("Rules::check_throw with minor lords", "[rules]") {
+  using C = std::vector<Card>;
+  const Card SA(Suit::S, Rank::_A), SK(Suit::S, Rank::_K),
+      SQ(Suit::S, Rank::_Q), S2(Suit::S, Rank::_2), H2(Suit::H, Rank::_2),
+      D2(Suit::D, Rank::_2), C2(Suit::C, Rank::_2), w(Suit::J, Rank::_w),
+      W(Suit::J, Rank::_W);
+
+  GIVEN("lordful rules") {
+    const Rules rules(Card(Suit::S, Rank::_2));
+    WHEN("a minor and a major lord pair make a tractor") {
+      CHECK(rules.check_throw({SA, SA, H2, H2, W}, {{C2, C2, S2, S2}}) ==
+            C{SA, SA, H2, H2});
+    }
+    WHEN("minor lord pairs of two suits are no tractor") {
+      CHECK(rules.check_throw({SA, SA, H2, H2, W}, {{C2, C2, D2, D2}})
+                .empty());
+    }
+    WHEN("a pair of aces joins one of the minor lord pairs") {
+      CHECK(rules.check_throw({SK, SK, SQ, SQ, W},
+                              {{SA, SA, C2, C2, D2, D2}}) ==
+            C{SQ, SQ, SK, SK});
+    }
+  }
+
+  GIVEN("overthrown lordless rules") {
+    const Rules rules(Card(Suit::J, Rank::_2));
+    WHEN("minor lords of other suits are as strong") {
+      CHECK(rules.check_throw({C2, C2, H2}, {{D2, D2, S2}}).empty());
+      CHECK(rules.check_throw({C2, C2, H2}, {{w}}) == C{H2});
+    }
+    WHEN("a tractor of minor lords and small jokers beats a pair") {
+      CHECK(rules.check_throw({C2, C2, W}, {{D2, D2, w, w}}) == C{C2, C2});
+    }
+  }
+}
 }  // namespace testRules
@@ -0,0 +1,115 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "common/card.hpp"
+#include "rules/composition_table.hpp"
+#include "rules/rules.hpp"
+#include "rules/rules_tables.hpp"
+
+using namespace rankup;
+
+namespace rankup {
+class TestRules {
+ public:
+  static auto parse(const Rules& rules, const std::vector<Card>& cards) {
+    return rules.parse_for_single_suit(cards)->cmp;
+  }
+};
+}  // namespace rankup
+
+SCENARIO("RulesTables round trip through a file", "[rules]") {
+  const std::string path = "test_rules_tables.bin";
+  const auto built = RulesTables::build();
+  built->write(path);
+
+  SECTION("loaded tables equal the built ones") {
+    const auto loaded = RulesTables::load(path);
+    for (int s = 0; s < 5; ++s) {
+      for (int r = 0; r < 15; ++r) {
+        const Card lord(static_cast<Suit>(s), static_cast<Rank>(r));
+        CHECK(std::memcmp(&built->mapping(lord), &loaded->mapping(lord),
+                          sizeof(CardMapping)) == 0);
+      }
+    }
+    for (int8_t n : {12, 13}) {
+      const auto a = built->composition_table(n);
+      const auto b = loaded->composition_table(n);
+      REQUIRE(a->size() == b->size());
+      CHECK(std::memcmp(a->data(), b->data(),
+                        a->size() * sizeof(PackedComposition)) == 0);
+    }
+  }
+
+  SECTION("Rules parse the same with loaded tables") {
+    const auto loaded = RulesTables::load(path);
+    const std::vector<std::vector<Card>> hands = {
+        {{Suit::D, Rank::_4}, {Suit::D, Rank::_4}, {Suit::D, Rank::_5},
+         {Suit::D, Rank::_5}, {Suit::D, Rank::_A}},
+        {{Suit::H, Rank::_8}, {Suit::H, Rank::_8}, {Suit::S, Rank::_8},
+         {Suit::S, Rank::_8}, {Suit::J, Rank::_w}},
+        {{Suit::C, Rank::_2}, {Suit::C, Rank::_3}, {Suit::C, Rank::_3}}};
+    for (const auto& lord : {Card(Suit::S, Rank::_8), Card(Suit::J, Rank::_8),
+                             Card(Suit::J, Rank::_W)}) {
+      const Rules plain(lord);
+      const Rules tabled(lord, loaded);
+      for (const auto& cards : hands) {
+        for (const auto& card : cards)
+          CHECK(plain.lorded_suit(card) == tabled.lorded_suit(card));
+        CHECK(TestRules::parse(plain, cards) ==
+              TestRules::parse(tabled, cards));
+      }
+    }
+  }
+
+  SECTION("Rules parse more than 2 copies of a value without the tables") {
+    const std::vector<std::vector<Card>> hands = {
+        {{Suit::H, Rank::_A}, {Suit::H, Rank::_A}, {Suit::H, Rank::_A}},
+        {{Suit::D, Rank::_5}, {Suit::D, Rank::_5}, {Suit::D, Rank::_5},
+         {Suit::D, Rank::_6}, {Suit::D, Rank::_6}}};
+    for (const auto& lord :
+         {Card(Suit::S, Rank::_8), Card(Suit::J, Rank::_W)}) {
+      const Rules plain(lord);
+      const Rules tabled(lord, built);
+      for (const auto& cards : hands)
+        CHECK(TestRules::parse(plain, cards) ==
+              TestRules::parse(tabled, cards));
+    }
+  }
+
+  SECTION("corrupted files are rejected") {
+    {
+      std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+      f.seekp(100000);
+      f.put(0x7f);
+    }
+    CHECK_THROWS_AS(RulesTables::load(path), std::runtime_error);
+    CHECK_NOTHROW(RulesTables::load(path, false));
+  }
+
+  SECTION("offsets out of the file are rejected") {
+    // the offsets of the mappings and of the table of 12 values
+    for (const int field : {32, 40}) {
+      built->write(path);
+      {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(field);
+        const std::uint64_t offset = std::uint64_t(1) << 40;
+        f.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+      }
+      CHECK_THROWS_AS(RulesTables::load(path), std::runtime_error);
+      CHECK_THROWS_AS(RulesTables::load(path, false), std::runtime_error);
+    }
+  }
+
+  SECTION("missing files are rejected") {
+    CHECK_THROWS_AS(RulesTables::load("no_such_tables.bin"),
+                    std::runtime_error);
+  }
+
+  std::remove(path.c_str());
+}
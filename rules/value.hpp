@@ -0,0 +1,97 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+#include "common/definitions.hpp"
+
+namespace rankup {
+class Value {
+ public:
+  // not made explicit to facilitate test writing.
+  Value(int8_t value, bool is_minor_lord = false,
+        Suit minor_lord_suit = Suit::D) {
+    m_data = (value << 3);
+    if (is_minor_lord) {
+      assert(minor_lord_suit != Suit::J);
+      m_data += (static_cast<int8_t>(minor_lord_suit) << 1) + 1;
+    }
+  }
+
+  /**
+     The inverse of full().
+   */
+  static Value from_full(int8_t full) {
+    Value res(0);
+    res.m_data = full;
+    return res;
+  }
+
+  int8_t full() const { return m_data; }
+
+  int8_t major() const { return m_data >> 3; }
+
+  int8_t minor() const { return (m_data >> 1) & 3; }
+
+  bool is_minor_lord() const { return m_data & 1; }
+
+  bool operator<(const Value& other) const { return full() < other.full(); }
+
+  bool operator==(const Value& other) const { return full() == other.full(); }
+
+ private:
+  int8_t m_data;
+};
+
+template <typename OStream>
+OStream& operator<<(OStream& o, const Value& val) {
+  o << static_cast<int>(val.major());
+  if (val.is_minor_lord()) {
+    o << "." << static_cast<int>(val.minor());
+  }
+  return o;
+}
+
+/**
+   Bitmask form of a set of values with the same lorded suit. Bit `v` of
+   `once` (`twice`) is set if there are at least one (two) non-minor-lord cards
+   with major() == v. Minor lords share the same major() and are counted per
+   minor() instead. Two decks are assumed, i.e. no card has more than two
+   copies.
+ */
+struct ValueCounts {
+  std::uint32_t once = 0;
+  std::uint32_t twice = 0;
+  std::array<int8_t, 4> minor = {0, 0, 0, 0};
+
+  void add(const Value& val) {
+    if (val.is_minor_lord()) {
+      ++minor[val.minor()];
+    } else {
+      const std::uint32_t bit = 1u << val.major();
+      twice |= once & bit;
+      once |= bit;
+    }
+  }
+
+  /**
+     Undo `add(val)`. The caller guarantees that val has been added.
+   */
+  void remove(const Value& val) {
+    if (val.is_minor_lord()) {
+      --minor[val.minor()];
+    } else {
+      const std::uint32_t bit = 1u << val.major();
+      if (twice & bit)
+        twice &= ~bit;
+      else
+        once &= ~bit;
+    }
+  }
+
+  bool empty() const {
+    return once == 0 and minor == std::array<int8_t, 4>{0, 0, 0, 0};
+  }
+};
+
+}  // namespace rankup
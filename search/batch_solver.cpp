@@ -0,0 +1,43 @@
+#include "search/batch_solver.hpp"
+
+#include "profile/trace.hpp"
+#include "search/parallel.hpp"
+
+namespace rankup {
+BatchSolver::BatchSolver(int num_threads, std::size_t table_memory,
+                         std::shared_ptr<const RulesTables> tables) {
+  num_threads = resolve_num_threads(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    m_solvers.push_back(
+        std::make_unique<DoubleDummySolver>(table_memory, tables));
+  }
+}
+
+BatchSolver::~BatchSolver() = default;
+
+void BatchSolver::solve(const std::vector<Deal>& deals,
+                        std::vector<int>& results) {
+  RANKUP_TRACE_SCOPE("BatchSolver::solve");
+  results.resize(deals.size());
+  parallel_for(deals.size(), num_threads(),
+               [this, &deals, &results](std::size_t d, int thread) {
+                 results[d] =
+                     m_solvers[thread]->solve(deals[d], deals[d].declarer);
+               });
+}
+
+void BatchSolver::solve_all_leaders(const std::vector<Deal>& deals,
+                                    std::vector<int>& results) {
+  RANKUP_TRACE_SCOPE("BatchSolver::solve_all_leaders");
+  results.resize(NUM_SEATS * deals.size());
+  // all leaders of a deal are solved by the same thread, which finds the
+  // positions shared by them in its transposition table
+  parallel_for(deals.size(), num_threads(),
+               [this, &deals, &results](std::size_t d, int thread) {
+                 for (int leader = 0; leader < NUM_SEATS; ++leader) {
+                   results[NUM_SEATS * d + leader] =
+                       m_solvers[thread]->solve(deals[d], leader);
+                 }
+               });
+}
+}  // namespace rankup
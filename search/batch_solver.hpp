@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "search/double_dummy.hpp"
+
+namespace rankup {
+class RulesTables;
+
+/**
+   Solves many deals in parallel with DoubleDummySolver. Each thread keeps
+   its own solver, including the transposition table, across deals and
+   across calls, and writes its results straight into the shared output
+   buffer.
+ */
+class BatchSolver {
+ public:
+  /**
+     @param num_threads, the number of threads, or 0 for all hardware threads
+     @param table_memory, the memory budget of the table of each thread
+     @param tables, if not nullptr, used by all threads to construct Rules
+   */
+  explicit BatchSolver(
+      int num_threads = 0,
+      std::size_t table_memory = DoubleDummySolver::DEFAULT_TABLE_MEMORY,
+      std::shared_ptr<const RulesTables> tables = nullptr);
+
+  ~BatchSolver();
+
+  int num_threads() const { return m_solvers.size(); }
+
+  /**
+     Solve each deal with its declarer leading the first trick.
+
+     @param results, resized to deals.size() and filled with the points of
+     the attackers of each deal
+
+     @throw std::runtime_error if any deal is invalid for
+     DoubleDummySolver::solve.
+   */
+  void solve(const std::vector<Deal>& deals, std::vector<int>& results);
+
+  /**
+     Solve each deal for every seat leading the first trick.
+
+     @param results, resized to NUM_SEATS * deals.size(), where
+     results[NUM_SEATS * d + leader] is the points of the attackers of deal d
+
+     @throw std::runtime_error if any deal is invalid for
+     DoubleDummySolver::solve.
+   */
+  void solve_all_leaders(const std::vector<Deal>& deals,
+                         std::vector<int>& results);
+
+ private:
+  std::vector<std::unique_ptr<DoubleDummySolver>> m_solvers;
+};
+}  // namespace rankup
@@ -0,0 +1,89 @@
+// Measure the scaling of ParallelIsmcts in iterations per second against the
+// number of threads, for root and tree parallelization alike, on the opening
+// lead of a random deal.
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/card_tracker.hpp"
+#include "search/parallel.hpp"
+#include "search/parallel_ismcts.hpp"
+#include "search/play_state.hpp"
+
+int main(int argc, char** argv) {
+  if (argc > 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " [max threads, default all] [milliseconds per run, default"
+                 " 2000]"
+              << std::endl;
+    return 1;
+  }
+
+  try {
+    using namespace rankup;
+    const int max_threads =
+        resolve_num_threads(argc > 1 ? std::stoi(argv[1]) : 0);
+    const std::chrono::milliseconds budget(argc > 2 ? std::stoi(argv[2])
+                                                    : 2000);
+
+    const Rules rules(Card(Suit::S, Rank::_2));
+    std::vector<Card> deck;
+    for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+      deck.push_back(Card::from_index(i));
+      deck.push_back(Card::from_index(i));
+    }
+    std::mt19937_64 gen(1);
+    std::shuffle(deck.begin(), deck.end(), gen);
+
+    PlayState state;
+    state.deal.lord_card = rules.lord_card();
+    state.deal.declarer = 0;
+    for (int s = 0; s < NUM_SEATS; ++s)
+      state.deal.hands[s] = CardSet(
+          std::vector<Card>(deck.begin() + 25 * s, deck.begin() + 25 * s + 25));
+    state.deal.kitty = CardSet(std::vector<Card>(deck.begin() + 100,
+                                                 deck.end()));
+    const CardTracker tracker(rules, 0, state.deal.hands[0],
+                              state.deal.kitty);
+
+    ParallelIsmcts search(rules);
+    ParallelIsmcts::Options options;
+    options.time_budget = budget;
+
+    std::cout << std::setw(8) << "threads" << std::setw(6) << "mode"
+              << std::setw(14) << "iterations/s" << std::setw(9) << "speedup"
+              << std::endl;
+    for (const auto mode :
+         {ParallelIsmcts::Mode::ROOT, ParallelIsmcts::Mode::TREE}) {
+      double base = 0;
+      for (int threads = 1;; threads = std::min(2 * threads, max_threads)) {
+        options.mode = mode;
+        options.num_threads = threads;
+        const auto start = std::chrono::steady_clock::now();
+        search.search(tracker, state, options);
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        const double rate = search.num_iterations() / elapsed.count();
+        if (threads == 1) base = rate;
+        std::cout << std::setw(8) << threads << std::setw(6)
+                  << (mode == ParallelIsmcts::Mode::ROOT ? "root" : "tree")
+                  << std::setw(14) << std::fixed << std::setprecision(0)
+                  << rate << std::setw(9) << std::setprecision(2)
+                  << rate / base << std::endl;
+        if (threads == max_threads) break;
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,80 @@
+// Measure the games per second of each rollout policy playing whole deals
+// from random deals, together with the mean points of the attackers.
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/moves.hpp"
+#include "search/play_state.hpp"
+#include "search/rollout.hpp"
+
+int main(int argc, char** argv) {
+  if (argc > 2) {
+    std::cerr << "Usage: " << argv[0] << " [number of deals, default 1000]"
+              << std::endl;
+    return 1;
+  }
+
+  try {
+    using namespace rankup;
+    const int num_deals = argc > 1 ? std::stoi(argv[1]) : 1000;
+
+    const Rules rules(Card(Suit::S, Rank::_2));
+    const MoveGenerator generator(rules);
+    std::vector<Card> deck;
+    for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+      deck.push_back(Card::from_index(i));
+      deck.push_back(Card::from_index(i));
+    }
+    std::mt19937_64 deal_gen(1);
+    std::vector<PlayState> deals(num_deals);
+    for (auto& state : deals) {
+      std::shuffle(deck.begin(), deck.end(), deal_gen);
+      state.deal.lord_card = rules.lord_card();
+      state.deal.declarer = 0;
+      for (int s = 0; s < NUM_SEATS; ++s)
+        state.deal.hands[s] = CardSet(std::vector<Card>(
+            deck.begin() + 25 * s, deck.begin() + 25 * s + 25));
+      state.deal.kitty =
+          CardSet(std::vector<Card>(deck.begin() + 100, deck.end()));
+    }
+
+    std::vector<std::pair<std::string, std::unique_ptr<RolloutPolicy>>>
+        policies;
+    policies.emplace_back("random", std::make_unique<RandomRollout>());
+    policies.emplace_back("greedy", std::make_unique<GreedyRollout>());
+    policies.emplace_back("heuristic", std::make_unique<HeuristicRollout>());
+
+    std::cout << std::setw(10) << "policy" << std::setw(10) << "games/s"
+              << std::setw(14) << "mean points" << std::endl;
+    for (auto& [name, policy] : policies) {
+      std::mt19937_64 gen(2);
+      long points = 0;
+      const auto start = std::chrono::steady_clock::now();
+      for (const auto& deal : deals) {
+        auto state = deal;
+        points += play_out(generator, state, *policy, gen);
+      }
+      const std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      std::cout << std::setw(10) << name << std::setw(10) << std::fixed
+                << std::setprecision(0) << num_deals / elapsed.count()
+                << std::setw(14) << std::setprecision(1)
+                << double(points) / num_deals << std::endl;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include "search/boss_cards.hpp"
+
+#include <algorithm>
+
+namespace rankup {
+BossCards::BossCards(const Rules& rules, const CardSet& out) {
+  for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+    const auto card = Card::from_index(i);
+    m_cards[static_cast<int>(rules.lorded_suit(card))][rules.strength(card)] |=
+        CardSet::bit(card);
+  }
+  update(out);
+}
+
+void BossCards::update(const CardSet& out) {
+  // a card has a copy left unless both are out, and both left unless one is
+  const auto left_once = ALL_CARD_BITS & ~out.twice();
+  const auto left_twice = ALL_CARD_BITS & ~out.once();
+  for (int s = 0; s < NUM_LORDED_SUITS; ++s) {
+    std::uint32_t singles = 0;
+    std::uint32_t pairs = 0;
+    for (int strength = 0; strength < NUM_STRENGTHS; ++strength) {
+      const auto cards = m_cards[s][strength];
+      singles |= std::uint32_t((cards & left_once) != 0) << strength;
+      pairs |= std::uint32_t((cards & left_twice) != 0) << strength;
+    }
+    m_singles[s] = singles;
+    m_pairs[s] = pairs;
+  }
+  const auto lords = m_cards[static_cast<int>(Suit::J)];
+  std::uint64_t lord_mask = 0;
+  for (const auto cards : lords) lord_mask |= cards;
+  m_num_lords = __builtin_popcountll(left_once & lord_mask) +
+                __builtin_popcountll(left_twice & lord_mask);
+}
+
+BossCards::Boss BossCards::boss(Suit lorded_suit) const {
+  const int s = static_cast<int>(lorded_suit);
+  Boss res;
+  res.single = highest_bit(m_singles[s]);
+  res.pair = highest_bit(m_pairs[s]);
+  res.tractor = highest_bit(runs_of(m_pairs[s], 2));
+  return res;
+}
+
+int8_t BossCards::highest_tractor(Suit lorded_suit, int num_pairs) const {
+  return highest_bit(runs_of(m_pairs[static_cast<int>(lorded_suit)],
+                             std::max(1, num_pairs)));
+}
+
+bool BossCards::wins_as_lead(const Composition& lead,
+                             bool check_trumps) const {
+  const int s = static_cast<int>(lead.suit());
+  bool wins = true;
+  int highest_axle = 0;
+  lead.for_each_component([&](int8_t axle, int8_t start) {
+    highest_axle = std::max<int>(highest_axle, axle);
+    const auto left = axle == 0 ? m_singles[s] : runs_of(m_pairs[s], axle);
+    if (left >> (start + 1)) wins = false;
+  });
+  if (!wins or !check_trumps or lead.suit() == Suit::J) return wins;
+
+  // the lords left may cover the format of lead, counting the lords of all
+  // other players together
+  if (m_num_lords < lead.total_num_cards()) return true;
+  if (highest_axle == 0) return false;
+  return runs_of(m_pairs[static_cast<int>(Suit::J)], highest_axle) == 0;
+}
+}  // namespace rankup
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "common/card_set.hpp"
+#include "common/strength_mask.hpp"
+#include "rules/rules.hpp"
+
+namespace rankup {
+/**
+   The strongest singles, pairs and tractors left in each lorded suit, i.e.
+   the boss cards a lead of that shape has to be at least as strong as to be
+   unbeatable.
+
+   Strengths are those of Rules::strength, over which the cards left are kept
+   as bitmasks per lorded suit, so that update() and every query take a few
+   nanoseconds. Tractors are runs of pairs of adjacent strengths, as in
+   MoveGenerator::leads.
+ */
+class BossCards {
+ public:
+  struct Boss {
+    // the strength of the highest single, pair and tractor of two pairs, or
+    // -1 if there is none
+    int8_t single = -1;
+    int8_t pair = -1;
+    int8_t tractor = -1;
+  };
+
+  /**
+     @param out, the cards no other player can play, e.g. the played cards
+     together with the hand of the leader
+   */
+  explicit BossCards(const Rules& rules, const CardSet& out = CardSet());
+
+  void update(const CardSet& out);
+
+  Boss boss(Suit lorded_suit) const;
+
+  /**
+     @return the strength at which the highest tractor of num_pairs pairs
+     left starts, or -1 if there is none
+   */
+  int8_t highest_tractor(Suit lorded_suit, int num_pairs) const;
+
+  /**
+     @param check_trumps, whether to consider trumping a lead of a folk suit
+     with the lords left. A caller knowing no other player is void in the
+     suit, e.g. from a CardTracker, can skip it.
+
+     @return whether lead wins its trick whatever the cards left, i.e. every
+     component of lead is at least as strong as the boss of its shape and, if
+     check_trumps, the lords left can't cover the format of lead
+   */
+  bool wins_as_lead(const Composition& lead, bool check_trumps = true) const;
+
+ private:
+  // the cards of each lorded suit and strength
+  std::array<std::array<std::uint64_t, NUM_STRENGTHS>, NUM_LORDED_SUITS>
+      m_cards{};
+  // the strengths of each lorded suit with a card, or both copies of one,
+  // left
+  std::array<std::uint32_t, NUM_LORDED_SUITS> m_singles{};
+  std::array<std::uint32_t, NUM_LORDED_SUITS> m_pairs{};
+  // the number of lords left
+  int m_num_lords = 0;
+};
+}  // namespace rankup
@@ -0,0 +1,79 @@
+#include "search/card_tracker.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "profile/stats.hpp"
+
+namespace rankup {
+namespace {
+[[noreturn]] void fail(const std::string& msg) {
+  RANKUP_STATS_COUNT(EXCEPTION);
+  throw std::runtime_error(msg);
+}
+
+int num_pairs_of(const Format& format) {
+  int res = 0;
+  for (int8_t axle = 1; axle <= format.total_num_cards() / 2; ++axle)
+    res += axle * format.get_count_at_or_0(axle);
+  return res;
+}
+}  // namespace
+
+CardTracker::CardTracker(const Rules& rules, int seat, const CardSet& hand,
+                         const CardSet& kitty)
+    : m_generator(rules), m_seat(seat), m_hand(hand),
+      m_unseen(ALL_CARD_BITS, ALL_CARD_BITS) {
+  if (seat < 0 or seat >= NUM_SEATS) fail("CardTracker called with no seat!");
+  m_unseen -= hand;
+  m_unseen -= kitty;
+  m_num_cards.fill(hand.size());
+}
+
+std::optional<int> CardTracker::next_seat() const {
+  if (!m_round) return std::nullopt;
+  return (m_leader + m_num_played) % NUM_SEATS;
+}
+
+void CardTracker::play(int seat, const CardSet& cards) {
+  if (seat < 0 or seat >= NUM_SEATS or (m_round and seat != *next_seat()))
+    fail("CardTracker::play called out of turn!");
+  if (cards.empty()) fail("CardTracker::play called with no cards!");
+  if (!cards.is_subset_of(seat == m_seat ? m_hand : m_unseen))
+    fail("CardTracker::play called with cards not in hand!");
+
+  const auto vec = cards.to_vector();
+  if (!m_round) {
+    m_round.emplace(m_generator.rules().start_round_with(vec));
+    m_leader = seat;
+    m_num_played = 0;
+    m_num_pairs = num_pairs_of(m_round->format());
+  } else {
+    const auto& format = m_round->format();
+    if (cards.size() != format.total_num_cards())
+      fail("CardTracker::play called with a wrong number of cards!");
+
+    const auto led = *format.suit();
+    const auto suited = m_generator.cards_of(cards, led);
+    const auto mask = m_generator.mask(led);
+    auto& excluded = m_excluded[seat];
+    if (suited.size() < cards.size()) {
+      m_void[seat] |= 1 << static_cast<int>(led);
+      m_no_pair[seat] |= 1 << static_cast<int>(led);
+      excluded = CardSet(excluded.once() | mask, excluded.twice() | mask);
+    } else if (__builtin_popcountll(suited.twice()) < m_num_pairs) {
+      m_no_pair[seat] |= 1 << static_cast<int>(led);
+      excluded = CardSet(excluded.once(), excluded.twice() | mask);
+    }
+    m_round->update_if_defeated_by(vec);
+  }
+
+  if (seat == m_seat)
+    m_hand -= cards;
+  else
+    m_unseen -= cards;
+  m_played += cards;
+  m_num_cards[seat] -= cards.size();
+  if (++m_num_played == NUM_SEATS) m_round.reset();
+}
+}  // namespace rankup
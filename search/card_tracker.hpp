@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/moves.hpp"
+
+namespace rankup {
+/**
+   What a player can tell about the cards of the others from the plays seen
+   so far: the cards not seen yet, and the lorded suits each seat is void in
+   or has no pair left in.
+
+   A seat is void in the led suit once it follows with fewer cards of that
+   suit than were led. A seat has no pair left in the led suit once it
+   follows with fewer pairs of that suit than the lead has, since
+   RoundRules::get_required_format makes every pair held be played. Every
+   play updates the state in time linear in the number of cards played.
+ */
+class CardTracker {
+ public:
+  /**
+     @param seat, the seat of the player tracking the cards
+     @param hand, the cards of the player
+     @param kitty, the kitty if the player buried it, and empty otherwise
+   */
+  CardTracker(const Rules& rules, int seat, const CardSet& hand,
+              const CardSet& kitty = CardSet());
+
+  /**
+     Record that seat played cards, leading a trick every NUM_SEATS plays.
+
+     @throw std::runtime_error if it isn't the turn of seat, or if the player
+     plays cards not in hand.
+   */
+  void play(int seat, const CardSet& cards);
+
+  int seat() const { return m_seat; }
+
+  const CardSet& hand() const { return m_hand; }
+
+  const CardSet& played() const { return m_played; }
+
+  /**
+     @return the cards neither in hand nor played nor buried by the player
+   */
+  const CardSet& unseen() const { return m_unseen; }
+
+  /**
+     @return the cards seat may hold, with each card counted as many times
+     as seat may hold it. The player's own hand for the player's seat.
+   */
+  CardSet possible(int seat) const {
+    if (seat == m_seat) return m_hand;
+    const auto& excluded = m_excluded[seat];
+    return CardSet(m_unseen.once() & ~excluded.once(),
+                   m_unseen.twice() & ~excluded.twice());
+  }
+
+  bool is_void(int seat, Suit lorded_suit) const {
+    return m_void[seat] >> static_cast<int>(lorded_suit) & 1;
+  }
+
+  bool has_no_pair(int seat, Suit lorded_suit) const {
+    return m_no_pair[seat] >> static_cast<int>(lorded_suit) & 1;
+  }
+
+  /**
+     @return the number of cards left in the hand of seat
+   */
+  int num_cards(int seat) const { return m_num_cards[seat]; }
+
+  /**
+     @return the rules of the current trick, or nullopt before its lead
+   */
+  const std::optional<RoundRules>& round() const { return m_round; }
+
+  /**
+     @return the seat to play next, or nullopt before the first lead and
+     after each trick, as the winner leads next
+   */
+  std::optional<int> next_seat() const;
+
+ private:
+  MoveGenerator m_generator;
+  int m_seat;
+
+  CardSet m_hand;
+  CardSet m_played;
+  CardSet m_unseen;
+  std::array<int, NUM_SEATS> m_num_cards{};
+
+  // per seat, the cards ruled out by the voids and missing pairs
+  std::array<CardSet, NUM_SEATS> m_excluded{};
+  // per seat, bitmasks over lorded suits
+  std::array<std::uint8_t, NUM_SEATS> m_void{};
+  std::array<std::uint8_t, NUM_SEATS> m_no_pair{};
+
+  std::optional<RoundRules> m_round;
+  int m_leader = 0;
+  int m_num_played = 0;
+  // the number of pairs of the lead of the current trick
+  int m_num_pairs = 0;
+};
+}  // namespace rankup
@@ -0,0 +1,210 @@
+#include "search/deal_sampler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "profile/stats.hpp"
+#include "profile/trace.hpp"
+#include "search/card_tracker.hpp"
+
+namespace rankup {
+namespace {
+[[noreturn]] void fail(const std::string& msg) {
+  RANKUP_STATS_COUNT(EXCEPTION);
+  throw std::runtime_error(msg);
+}
+}  // namespace
+
+DealSampler::DealSampler(const CardSet& cards,
+                         const std::vector<CardSet>& allowed,
+                         const std::vector<int>& counts) {
+  init(cards, allowed, counts);
+}
+
+DealSampler::DealSampler(const CardTracker& tracker, int kitty_size) {
+  std::vector<CardSet> allowed;
+  std::vector<int> counts;
+  for (int s = 0; s < NUM_SEATS; ++s) {
+    const bool own = s == tracker.seat();
+    allowed.push_back(own ? CardSet() : tracker.possible(s));
+    counts.push_back(own ? 0 : tracker.num_cards(s));
+  }
+  if (kitty_size > 0) {
+    allowed.push_back(tracker.unseen());
+    counts.push_back(kitty_size);
+  }
+  init(tracker.unseen(), allowed, counts);
+}
+
+void DealSampler::init(const CardSet& cards,
+                       const std::vector<CardSet>& allowed,
+                       const std::vector<int>& counts) {
+  RANKUP_TRACE_SCOPE("DealSampler::init");
+  m_num_bins = counts.size();
+  if (m_num_bins == 0 or m_num_bins > MAX_BINS or
+      allowed.size() != counts.size())
+    fail("DealSampler called with a wrong number of bins!");
+  int total = 0;
+  for (const auto count : counts) {
+    if (count < 0) fail("DealSampler called with a negative count!");
+    total += count;
+  }
+  if (total != cards.size())
+    fail("DealSampler called with counts not adding up to the cards!");
+
+  // the bin with the most cards is left out of the state to keep it small
+  m_implicit = std::max_element(counts.begin(), counts.end()) - counts.begin();
+  m_strides.assign(m_num_bins, 0);
+  m_num_states = 1;
+  for (int b = 0; b < m_num_bins; ++b) {
+    if (b == m_implicit) continue;
+    m_strides[b] = m_num_states;
+    m_num_states *= counts[b] + 1;
+  }
+  m_start = 0;
+  for (int b = 0; b < m_num_bins; ++b) m_start += counts[b] * m_strides[b];
+
+  m_layers.clear();
+  for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+    const auto card = Card::from_index(i);
+    const int num_copies = cards.count(card);
+    if (num_copies == 0) continue;
+
+    Layer layer{card, num_copies, {}, 0};
+    for (int b0 = 0; b0 < m_num_bins; ++b0) {
+      if (num_copies == 1) {
+        if (allowed[b0].count(card) >= 1)
+          layer.options.push_back(
+              {{static_cast<int8_t>(b0), -1}, 1, m_strides[b0]});
+        continue;
+      }
+      if (allowed[b0].count(card) == 2) {
+        layer.options.push_back({{static_cast<int8_t>(b0),
+                                  static_cast<int8_t>(b0)},
+                                 2,
+                                 2 * m_strides[b0]});
+      }
+      for (int b1 = b0 + 1; b1 < m_num_bins; ++b1) {
+        if (allowed[b0].count(card) >= 1 and allowed[b1].count(card) >= 1) {
+          layer.options.push_back(
+              {{static_cast<int8_t>(b0), static_cast<int8_t>(b1)},
+               2,
+               m_strides[b0] + m_strides[b1]});
+        }
+      }
+    }
+    if (layer.options.empty())
+      fail("DealSampler found no deal satisfying the constraints!");
+    m_layers.push_back(std::move(layer));
+  }
+
+  const int num_layers = m_layers.size();
+  std::vector<int> num_left(num_layers + 1, 0);
+  for (int k = num_layers - 1; k >= 0; --k)
+    num_left[k] = num_left[k + 1] + m_layers[k].num_copies;
+
+  std::size_t num_thresholds = 0;
+  for (auto& layer : m_layers) {
+    layer.offset = num_thresholds;
+    num_thresholds +=
+        static_cast<std::size_t>(layer.options.size() - 1) * m_num_states;
+  }
+  m_thresholds.assign(num_thresholds, 0);
+
+  // the ways to deal the cards of the layers from the next one on, and
+  // from this one on, by the numbers of cards still wanted by the bins
+  std::vector<double> next(m_num_states, 0);
+  std::vector<double> ways(m_num_states, 0);
+  next[0] = 1;
+  int wants[MAX_BINS];
+  double weights[MAX_BINS * (MAX_BINS + 1) / 2];
+  for (int k = num_layers - 1; k >= 0; --k) {
+    const auto& layer = m_layers[k];
+    const int num_options = layer.options.size();
+    for (int state = 0; state < m_num_states; ++state) {
+      ways[state] = 0;
+      int explicit_sum = 0;
+      for (int b = 0; b < m_num_bins; ++b) {
+        if (b == m_implicit) continue;
+        wants[b] = state / m_strides[b] % (counts[b] + 1);
+        explicit_sum += wants[b];
+      }
+      wants[m_implicit] = num_left[k] - explicit_sum;
+      if (wants[m_implicit] < 0 or wants[m_implicit] > counts[m_implicit])
+        continue;
+
+      double sum = 0;
+      for (int j = 0; j < num_options; ++j) {
+        const auto& option = layer.options[j];
+        const int b0 = option.bins[0];
+        const int b1 = option.bins[1];
+        const bool valid =
+            option.num_bins == 1 ? wants[b0] >= 1
+            : b0 == b1           ? wants[b0] >= 2
+                                 : wants[b0] >= 1 and wants[b1] >= 1;
+        weights[j] = valid ? next[state - option.delta] : 0;
+        sum += weights[j];
+      }
+      ways[state] = sum;
+      if (sum == 0) continue;
+
+      // the options left out of the state have zero width, the last one
+      // included, whose threshold is then exactly THRESHOLD_ONE
+      auto* thresholds =
+          &m_thresholds[layer.offset +
+                        static_cast<std::size_t>(state) * (num_options - 1)];
+      double cumulative = 0;
+      for (int j = 0; j + 1 < num_options; ++j) {
+        cumulative += weights[j];
+        thresholds[j] =
+            static_cast<std::uint32_t>(cumulative / sum * THRESHOLD_ONE);
+      }
+    }
+    std::swap(next, ways);
+  }
+
+  m_num_deals = next[m_start];
+  if (m_num_deals == 0)
+    fail("DealSampler found no deal satisfying the constraints!");
+}
+
+void DealSampler::sample(std::mt19937_64& gen,
+                         std::vector<CardSet>& bins) const {
+  std::uint64_t once[MAX_BINS] = {};
+  std::uint64_t twice[MAX_BINS] = {};
+  int state = m_start;
+  // each draw of gen gives the uniform numbers of two layers
+  std::uint64_t bits = 0;
+  bool has_bits = false;
+  for (const auto& layer : m_layers) {
+    const int num_thresholds = layer.options.size() - 1;
+    int chosen = 0;
+    if (num_thresholds > 0) {
+      if (has_bits) {
+        bits >>= 32;
+      } else {
+        bits = gen();
+      }
+      has_bits = !has_bits;
+      const std::uint32_t u = bits & (THRESHOLD_ONE - 1);
+      const auto* thresholds =
+          &m_thresholds[layer.offset +
+                        static_cast<std::size_t>(state) * num_thresholds];
+      for (int j = 0; j < num_thresholds; ++j) chosen += u >= thresholds[j];
+    }
+
+    const auto& option = layer.options[chosen];
+    const auto bit = CardSet::bit(layer.card);
+    for (int i = 0; i < option.num_bins; ++i) {
+      const int b = option.bins[i];
+      twice[b] |= once[b] & bit;
+      once[b] |= bit;
+    }
+    state -= option.delta;
+  }
+
+  bins.resize(m_num_bins);
+  for (int b = 0; b < m_num_bins; ++b) bins[b] = CardSet(once[b], twice[b]);
+}
+}  // namespace rankup
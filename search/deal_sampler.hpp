@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "common/card_set.hpp"
+
+namespace rankup {
+class CardTracker;
+
+/**
+   Uniform sampler of the ways to deal a set of cards into bins, e.g. the
+   unseen cards into the hands of the other players and the kitty, where
+   each bin takes a given number of cards and only the cards it is allowed.
+   Deals are distinct by the cards of each bin, copies of a card being the
+   same.
+
+   The constructor counts the deals completing every partial deal of the
+   cards, kind by kind, by dynamic programming over the numbers of cards
+   still wanted by the bins. sample() then deals each kind of cards with
+   probabilities proportional to these counts, so that every deal is drawn
+   with the same probability and nothing is ever rejected, however tight
+   the constraints.
+
+   The probabilities are kept as cumulative thresholds over the options of
+   each kind and state, on 31 bits, so that sample() only compares half a
+   draw of the generator to a row of them per kind. They take 4 bytes per
+   option and state, e.g. about 12MB with 83 unseen cards early in a hand.
+
+   Where a draw of std::mt19937_64 costs 8ns, sample() gives about 750
+   deals/ms with 75 unseen cards, 1300 with 40 and 4400 with 15. Early in a
+   hand it falls short of thousands of deals/ms, as most of the rows it
+   reads miss the caches; a search spends far longer on the rollout of each
+   deal anyway.
+ */
+class DealSampler {
+ public:
+  inline static constexpr int MAX_BINS = NUM_SEATS + 1;
+
+  /**
+     @param allowed, the cards each bin may take, with each card counted as
+     many times as the bin may take it
+     @param counts, the number of cards of each bin
+
+     @throw std::runtime_error if there are no or too many bins, if the
+     counts don't add up to the number of cards, or if no deal satisfies the
+     constraints.
+   */
+  DealSampler(const CardSet& cards, const std::vector<CardSet>& allowed,
+              const std::vector<int>& counts);
+
+  /**
+     Sample the hands of the other players from what tracker has seen. The
+     bins are the seats, where that of tracker is left empty, followed by the
+     kitty if kitty_size is positive, which takes any unseen cards.
+
+     @throw std::runtime_error if no deal satisfies the constraints.
+   */
+  DealSampler(const CardTracker& tracker, int kitty_size);
+
+  /**
+     @return the number of deals, which may be too large to be exact
+   */
+  double num_deals() const { return m_num_deals; }
+
+  int num_bins() const { return m_num_bins; }
+
+  /**
+     Draw a deal into bins, resized to num_bins(). It is thread-safe given a
+     generator per thread.
+   */
+  void sample(std::mt19937_64& gen, std::vector<CardSet>& bins) const;
+
+ private:
+  // a way to deal the copies of a kind of cards, i.e. the bins taking one
+  // copy each or the bin taking both
+  struct Option {
+    std::int8_t bins[2];
+    std::int8_t num_bins;
+    // the decrease of the state, whose bin with the most cards is implicit
+    std::int32_t delta;
+  };
+
+  struct Layer {
+    Card card;
+    int num_copies;
+    std::vector<Option> options;
+    // the start of the thresholds of the layer in m_thresholds
+    std::size_t offset;
+  };
+
+  // the probability 1 of the thresholds
+  inline static constexpr std::uint32_t THRESHOLD_ONE = 1u << 31;
+
+  int m_num_bins;
+  // the bin whose count is implied by the number of cards left
+  int m_implicit;
+  std::vector<int> m_strides;
+  int m_num_states;
+  int m_start;
+  double m_num_deals;
+
+  std::vector<Layer> m_layers;
+  // m_thresholds[layer.offset + state * (layer.options.size() - 1) + j],
+  // the probability, times THRESHOLD_ONE, to take one of options 0 to j of
+  // layer with state giving the numbers of cards still wanted by the bins
+  std::vector<std::uint32_t> m_thresholds;
+
+  void init(const CardSet& cards, const std::vector<CardSet>& allowed,
+            const std::vector<int>& counts);
+
+};
+}  // namespace rankup
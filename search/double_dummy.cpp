@@ -0,0 +1,230 @@
+#include "search/double_dummy.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "common/hash.hpp"
+#include "profile/stats.hpp"
+#include "profile/trace.hpp"
+
+namespace rankup {
+int kitty_multiplier(const Composition& winning) {
+  int8_t max_axle = 0;
+  for (int8_t axle = 1; axle <= winning.total_num_cards() / 2; ++axle) {
+    if (winning.format().get_count_at_or_0(axle) > 0) max_axle = axle;
+  }
+  return 2 * (max_axle == 0 ? 1 : 2 * max_axle);
+}
+
+DoubleDummySolver::DoubleDummySolver(std::size_t table_memory,
+                                     std::shared_ptr<const RulesTables> tables)
+    : m_table(table_memory), m_tables(std::move(tables)) {}
+
+DoubleDummySolver::~DoubleDummySolver() = default;
+
+int DoubleDummySolver::solve(const Deal& deal, int leader) {
+  RANKUP_TRACE_SCOPE("DoubleDummySolver::solve");
+  if (leader < 0 or leader >= NUM_SEATS or deal.declarer < 0 or
+      deal.declarer >= NUM_SEATS) {
+    RANKUP_STATS_COUNT(EXCEPTION);
+    throw std::runtime_error("DoubleDummySolver::solve called with no seat!");
+  }
+  const int hand_size = deal.hands[0].size();
+  for (const auto& hand : deal.hands) {
+    if (hand.size() != hand_size) {
+      RANKUP_STATS_COUNT(EXCEPTION);
+      throw std::runtime_error(
+          "DoubleDummySolver::solve called with hands of different sizes!");
+    }
+  }
+
+  if (!m_rules or m_rules->lord_card() != deal.lord_card) {
+    m_generator.reset();
+    m_rules = m_tables ? std::make_unique<Rules>(deal.lord_card, m_tables)
+                       : std::make_unique<Rules>(deal.lord_card);
+    m_generator = std::make_unique<MoveGenerator>(*m_rules);
+  }
+
+  m_deal = &deal;
+  m_hands = deal.hands;
+  m_hands_hash = 0;
+  for (int s = 0; s < NUM_SEATS; ++s)
+    m_hands_hash ^= Zobrist::hash(s, m_hands[s]);
+  m_kitty_points = deal.kitty.points();
+  m_context = mix64(Zobrist::hash(0, deal.kitty) ^
+                    (static_cast<std::uint64_t>(deal.lord_card.index()) << 8 |
+                     (deal.declarer % 2)));
+
+  // one more ply than cards, keeping the buffers of longer deals
+  m_moves.resize(NUM_SEATS * hand_size + 1);
+  m_order.resize(NUM_SEATS * hand_size + 1);
+
+  m_table.new_search();
+  m_num_nodes = 0;
+  m_best_move = {};
+  return search(leader, Trick(), std::numeric_limits<int>::min(),
+                std::numeric_limits<int>::max(), 0);
+}
+
+Zobrist::Key DoubleDummySolver::key_of(int seat, const Trick& trick) const {
+  auto key = m_hands_hash ^ Zobrist::turn_key(seat) ^ m_context;
+  if (trick.round) {
+    key ^= mix64(Zobrist::hash(*trick.round) +
+                 (static_cast<std::uint64_t>(trick.winner) << 16 |
+                  static_cast<std::uint64_t>(trick.points)));
+  }
+  return key;
+}
+
+void DoubleDummySolver::play(int seat, const CardSet& move) {
+  for (const auto& card : move.to_vector()) {
+    m_hands_hash ^= Zobrist::key_to_remove(seat, m_hands[seat], card);
+    m_hands[seat].remove(card);
+  }
+}
+
+void DoubleDummySolver::unplay(int seat, const CardSet& move) {
+  for (const auto& card : move.to_vector()) {
+    m_hands_hash ^= Zobrist::key_to_add(seat, m_hands[seat], card);
+    m_hands[seat].add(card);
+  }
+}
+
+int DoubleDummySolver::search(int seat, const Trick& trick, int alpha,
+                              int beta, int ply) {
+  ++m_num_nodes;
+  const auto key = key_of(seat, trick);
+  m_table.prefetch(key);
+
+  // the value is the number of points the attackers collect from now on,
+  // including those already in the current trick
+  const int alpha_orig = alpha;
+  const int beta_orig = beta;
+  CardSet table_move;
+  if (const auto entry = m_table.probe(key)) {
+    table_move = entry->best_move;
+    using Bound = TranspositionTable::Bound;
+    if (entry->bound == Bound::EXACT) {
+      if (ply == 0) m_best_move = table_move;
+      return entry->value;
+    }
+    if (entry->bound == Bound::LOWER)
+      alpha = std::max<int>(alpha, entry->value);
+    if (entry->bound == Bound::UPPER) beta = std::min<int>(beta, entry->value);
+    if (alpha >= beta) {
+      if (ply == 0) m_best_move = table_move;
+      return entry->value;
+    }
+  }
+
+  auto& moves = m_moves[ply];
+  moves.clear();
+  if (trick.round) {
+    m_generator->follows(*trick.round, m_hands[seat], moves);
+  } else {
+    m_generator->leads(m_hands[seat], moves);
+    m_others.resize(NUM_SEATS - 1);
+    for (int i = 1; i < NUM_SEATS; ++i)
+      m_others[i - 1] = m_hands[(seat + i) % NUM_SEATS].to_vector();
+    m_generator->throws(m_hands[seat], m_others, moves);
+  }
+
+  // order moves by a score: the move from the table first, then larger and
+  // stronger leads, and follows that give points to the team currently
+  // winning the trick
+  const bool maximizing = is_attacker(*m_deal, seat);
+  auto& order = m_order[ply];
+  order.clear();
+  for (int i = 0; i < static_cast<int>(moves.size()); ++i) {
+    const auto& move = moves[i];
+    int score = 0;
+    if (move == table_move) {
+      score = std::numeric_limits<int>::max();
+    } else if (!trick.round) {
+      const auto highest =
+          Card::from_index(63 - __builtin_clzll(move.once()));
+      score = 32 * move.size() + m_rules->strength(highest);
+    } else {
+      const bool partner_winning = (trick.winner - seat) % 2 == 0;
+      score = partner_winning ? move.points() : -move.points();
+    }
+    order.emplace_back(score, i);
+  }
+  std::sort(order.begin(), order.end(),
+            [](const auto& a, const auto& b) { return a.first > b.first; });
+
+  int best = maximizing ? std::numeric_limits<int>::min()
+                        : std::numeric_limits<int>::max();
+  CardSet best_move;
+  for (const auto& [score, i] : order) {
+    const auto move = moves[i];
+    const auto cards = move.to_vector();
+
+    Trick next;
+    if (trick.round) {
+      next.round.emplace(*trick.round);
+      next.winner =
+          next.round->update_if_defeated_by(cards) ? seat : trick.winner;
+    } else {
+      next.round.emplace(m_rules->start_round_with(cards));
+      next.winner = seat;
+    }
+    next.points = trick.points + move.points();
+    next.num_played = trick.num_played + 1;
+
+    play(seat, move);
+    int value = 0;
+    if (next.num_played < NUM_SEATS) {
+      value = search((seat + 1) % NUM_SEATS, next, alpha, beta, ply + 1);
+    } else {
+      const bool attackers_win = is_attacker(*m_deal, next.winner);
+      int gained = attackers_win ? next.points : 0;
+      if (m_hands[next.winner].empty()) {
+        if (attackers_win) {
+          gained += m_kitty_points *
+                    kitty_multiplier(next.round->winning_composition());
+        }
+        value = gained;
+      } else {
+        // guard the window against overflow at the infinities
+        auto shift = [gained](int bound) {
+          if (bound == std::numeric_limits<int>::min() or
+              bound == std::numeric_limits<int>::max())
+            return bound;
+          return bound - gained;
+        };
+        value = gained + search(next.winner, Trick(), shift(alpha),
+                                shift(beta), ply + 1);
+      }
+    }
+    unplay(seat, move);
+
+    if (maximizing ? value > best : value < best) {
+      best = value;
+      best_move = move;
+    }
+    if (maximizing)
+      alpha = std::max(alpha, best);
+    else
+      beta = std::min(beta, best);
+    if (alpha >= beta) break;
+  }
+
+  TranspositionTable::Entry entry;
+  entry.value = static_cast<std::int16_t>(best);
+  // the number of cards left to play measures the size of the subtree
+  entry.depth = static_cast<std::uint8_t>(m_moves.size() - 1 - ply);
+  entry.best_move = best_move;
+  if (best <= alpha_orig)
+    entry.bound = TranspositionTable::Bound::UPPER;
+  else if (best >= beta_orig)
+    entry.bound = TranspositionTable::Bound::LOWER;
+  else
+    entry.bound = TranspositionTable::Bound::EXACT;
+  m_table.store(key, entry);
+
+  if (ply == 0) m_best_move = best_move;
+  return best;
+}
+}  // namespace rankup
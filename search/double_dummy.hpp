@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/moves.hpp"
+#include "search/transposition_table.hpp"
+#include "search/zobrist.hpp"
+
+namespace rankup {
+class RulesTables;
+
+/**
+   A deal with every card known. The declarer's team defends, and the other
+   team attacks, i.e. collects points.
+ */
+struct Deal {
+  Card lord_card = Card(Suit::J, Rank::_W);
+  int declarer = 0;
+  std::array<CardSet, NUM_SEATS> hands;
+  // the cards buried by the declarer, whose points go to the attackers if
+  // they win the last trick
+  CardSet kitty;
+};
+
+inline bool is_attacker(const Deal& deal, int seat) {
+  return (seat - deal.declarer) % 2 != 0;
+}
+
+/**
+   @return the factor of the kitty points when the attackers win the last
+   trick with `winning`, i.e. twice the number of cards of its largest
+   component: 2 for a single, 4 for a pair, 8 for a tractor of two pairs etc.
+ */
+int kitty_multiplier(const Composition& winning);
+
+/**
+   Perfect-information solver of deals, i.e. the double dummy problem of
+   Shengji. It runs an alpha-beta search over every card play, with tricks
+   resolved by RoundRules, moves from MoveGenerator ordered by the
+   transposition table and a point heuristic.
+
+   Leads are those of MoveGenerator::leads and MoveGenerator::throws, i.e.
+   every single component and, per suit, one throw settled against the
+   other hands. A throw that fails is played as the component
+   Rules::check_throw returns, so only throws that stand are searched. Other
+   throws of fewer components aren't, so the value is that of optimal play
+   among these leads rather than of the full game.
+
+   A solver is meant to be reused for many deals, since its transposition
+   table is allocated once. It is not thread-safe; use one solver per thread.
+ */
+class DoubleDummySolver {
+ public:
+  inline static constexpr std::size_t DEFAULT_TABLE_MEMORY = 1 << 24;
+
+  /**
+     @param tables, if not nullptr, used to construct the Rules of each deal
+   */
+  explicit DoubleDummySolver(
+      std::size_t table_memory = DEFAULT_TABLE_MEMORY,
+      std::shared_ptr<const RulesTables> tables = nullptr);
+
+  ~DoubleDummySolver();
+
+  /**
+     @return the points the attackers collect when leader leads the first
+     trick and both teams play optimally, including the multiplied kitty if
+     the attackers win the last trick
+
+     @throw std::runtime_error if the hands have different numbers of cards,
+     or if leader or the declarer isn't a seat.
+   */
+  int solve(const Deal& deal, int leader);
+
+  /**
+     @return an optimal first play of the last solved deal
+   */
+  const CardSet& best_move() const { return m_best_move; }
+
+  /**
+     @return the number of positions visited by the last solve
+   */
+  std::uint64_t num_nodes() const { return m_num_nodes; }
+
+ private:
+  struct Trick {
+    std::optional<RoundRules> round;
+    int winner = 0;
+    int points = 0;
+    int num_played = 0;
+  };
+
+  TranspositionTable m_table;
+  std::shared_ptr<const RulesTables> m_tables;
+
+  std::unique_ptr<Rules> m_rules;
+  std::unique_ptr<MoveGenerator> m_generator;
+
+  const Deal* m_deal = nullptr;
+  std::array<CardSet, NUM_SEATS> m_hands;
+  Zobrist::Key m_hands_hash = 0;
+  // mixed into every key, so that positions of different deals sharing the
+  // table don't match
+  Zobrist::Key m_context = 0;
+  int m_kitty_points = 0;
+
+  // buffers of moves and their order, indexed by the number of cards played
+  std::vector<std::vector<CardSet>> m_moves;
+  std::vector<std::vector<std::pair<int, int>>> m_order;
+  // the hands of the other players when generating throws
+  std::vector<std::vector<Card>> m_others;
+
+  CardSet m_best_move;
+  std::uint64_t m_num_nodes = 0;
+
+  int search(int seat, const Trick& trick, int alpha, int beta, int ply);
+
+  Zobrist::Key key_of(int seat, const Trick& trick) const;
+
+  void play(int seat, const CardSet& move);
+  void unplay(int seat, const CardSet& move);
+};
+}  // namespace rankup
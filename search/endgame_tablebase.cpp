@@ -0,0 +1,204 @@
+#include "search/endgame_tablebase.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "common/hash.hpp"
+#include "profile/stats.hpp"
+#include "profile/trace.hpp"
+#include "rules/file_image.hpp"
+#include "search/parallel.hpp"
+#include "search/suit_symmetry.hpp"
+
+namespace rankup {
+namespace {
+constexpr char MAGIC[8] = {'R', 'A', 'N', 'K', 'U', 'P', 'E', 'G'};
+
+[[noreturn]] void fail(const std::string& msg) {
+  RANKUP_STATS_COUNT(EXCEPTION);
+  throw std::runtime_error(msg);
+}
+
+// a kitty of the given points. Only its points matter to the solver.
+CardSet kitty_of(int points) {
+  CardSet res;
+  for (int8_t i = 0; i < NUM_CARD_KINDS and points > 0; ++i) {
+    const auto card = Card::from_index(i);
+    for (int copy = 0; copy < NUM_DECKS; ++copy) {
+      if (points_of(card) == 0 or points_of(card) > points) break;
+      res.add(card);
+      points -= points_of(card);
+    }
+  }
+  return res;
+}
+}  // namespace
+
+Zobrist::Key EndgameTablebase::key_of(const Deal& deal, int leader) {
+  return keys_of(deal, leader).first;
+}
+
+std::pair<Zobrist::Key, std::uint32_t> EndgameTablebase::keys_of(
+    const Deal& deal, int leader) {
+  std::array<CardSet, NUM_SEATS> hands;
+  for (int i = 0; i < NUM_SEATS; ++i)
+    hands[i] = deal.hands[(leader + i) % NUM_SEATS];
+  const auto suits = canonical_suits(deal.lord_card, hands.data(), NUM_SEATS);
+  for (auto& hand : hands) hand = suits(hand);
+
+  const std::uint64_t lord = deal.lord_card.index();
+  const std::uint64_t attacking = is_attacker(deal, leader);
+  const std::uint64_t kitty_points = deal.kitty.points();
+  const std::uint64_t rest = lord | attacking << 8 | kitty_points << 16;
+
+  Zobrist::Key key = 0;
+  for (int i = 0; i < NUM_SEATS; ++i) key ^= Zobrist::hash(i, hands[i]);
+
+  // chained over the bits of the hands, independent of the Zobrist keys
+  std::uint64_t check = mix64(rest);
+  for (const auto& hand : hands) {
+    check = mix64(check ^ hand.once());
+    check = mix64(check ^ hand.twice());
+  }
+  return {key ^ mix64(rest), static_cast<std::uint32_t>(check >> 32)};
+}
+
+std::shared_ptr<const EndgameTablebase> EndgameTablebase::build(
+    const Card& lord_card, const std::vector<CardSet>& remainders,
+    const std::vector<int>& kitty_points, int num_threads) {
+  RANKUP_TRACE_SCOPE("EndgameTablebase::build");
+  for (const auto& remainder : remainders) {
+    const int size = remainder.size();
+    if (size == 0 or size % NUM_SEATS != 0 or
+        size > NUM_SEATS * MAX_HAND_SIZE)
+      fail("EndgameTablebase::build called with a wrong number of cards!");
+  }
+  for (const auto points : kitty_points) {
+    if (points < 0 or points > 200 or points % 5 != 0)
+      fail("EndgameTablebase::build called with wrong kitty points!");
+  }
+
+  num_threads = resolve_num_threads(num_threads);
+  std::vector<std::unique_ptr<DoubleDummySolver>> solvers;
+  std::vector<std::vector<Entry>> entries(num_threads);
+  for (int t = 0; t < num_threads; ++t)
+    solvers.push_back(std::make_unique<DoubleDummySolver>(1 << 22));
+
+  parallel_for(remainders.size(), num_threads, [&](std::size_t r, int thread) {
+    const auto& remainder = remainders[r];
+    const int hand_size = remainder.size() / NUM_SEATS;
+    auto& solver = *solvers[thread];
+    auto& out = entries[thread];
+
+    Deal deal;
+    deal.lord_card = lord_card;
+    // with seat 0 leading, declarers 0 and 1 make either team attack
+    auto solve_all = [&]() {
+      for (const auto points : kitty_points) {
+        deal.kitty = kitty_of(points);
+        for (int declarer = 0; declarer < 2; ++declarer) {
+          deal.declarer = declarer;
+          const auto [key, check] = keys_of(deal, 0);
+          out.push_back({key, solver.solve(deal, 0), check});
+        }
+      }
+    };
+
+    for_each_subset(remainder, hand_size, [&](const CardSet& hand_0) {
+      auto rest_0 = remainder;
+      rest_0 -= hand_0;
+      deal.hands[0] = hand_0;
+      for_each_subset(rest_0, hand_size, [&](const CardSet& hand_1) {
+        auto rest_1 = rest_0;
+        rest_1 -= hand_1;
+        deal.hands[1] = hand_1;
+        for_each_subset(rest_1, hand_size, [&](const CardSet& hand_2) {
+          deal.hands[2] = hand_2;
+          deal.hands[3] = rest_1;
+          deal.hands[3] -= hand_2;
+          solve_all();
+        });
+      });
+    });
+  });
+
+  // merge, dropping positions that are the same up to suits, which have the
+  // same keys and values
+  std::vector<Entry> merged;
+  for (auto& e : entries) {
+    merged.insert(merged.end(), e.begin(), e.end());
+    std::vector<Entry>().swap(e);
+  }
+  std::sort(merged.begin(), merged.end(), [](const Entry& a, const Entry& b) {
+    return a.key < b.key or (a.key == b.key and a.check < b.check);
+  });
+  merged.erase(std::unique(merged.begin(), merged.end(),
+                           [](const Entry& a, const Entry& b) {
+                             return a.key == b.key and a.check == b.check;
+                           }),
+               merged.end());
+  const auto collision = std::adjacent_find(
+      merged.begin(), merged.end(),
+      [](const Entry& a, const Entry& b) { return a.key == b.key; });
+  if (collision != merged.end())
+    fail("EndgameTablebase::build found different positions of the same "
+         "key!");
+
+  Header header = {};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.entries_offset = sizeof(Header);
+  header.num_entries = merged.size();
+  header.size = sizeof(Header) + merged.size() * sizeof(Entry);
+
+  const auto owner = allocate_file_image(header.size);
+  auto* image = owner.get();
+  std::memcpy(image + header.entries_offset, merged.data(),
+              merged.size() * sizeof(Entry));
+  header.checksum =
+      file_image_checksum(image + sizeof(Header), header.size - sizeof(Header));
+  std::memcpy(image, &header, sizeof(Header));
+
+  std::shared_ptr<EndgameTablebase> res(new EndgameTablebase);
+  res->attach(owner);
+  return res;
+}
+
+std::shared_ptr<const EndgameTablebase> EndgameTablebase::load(
+    const std::string& path, bool verify_checksum) {
+  auto image = map_file_image(path, MAGIC, VERSION, sizeof(Header),
+                              verify_checksum, "EndgameTablebase::load");
+  const auto* header = static_cast<const Header*>(image.get());
+  if (header->size !=
+      header->entries_offset + header->num_entries * sizeof(Entry))
+    fail("EndgameTablebase::load found a wrong size in " + path);
+
+  std::shared_ptr<EndgameTablebase> res(new EndgameTablebase);
+  res->attach(std::move(image));
+  return res;
+}
+
+void EndgameTablebase::attach(std::shared_ptr<const void> image) {
+  m_image = std::move(image);
+  const auto* bytes = static_cast<const unsigned char*>(m_image.get());
+  m_entries = reinterpret_cast<const Entry*>(bytes + header().entries_offset);
+  m_num_entries = header().num_entries;
+}
+
+void EndgameTablebase::write(const std::string& path) const {
+  write_file_image(m_image.get(), header().size, path,
+                   "EndgameTablebase::write");
+}
+
+std::optional<int> EndgameTablebase::probe(const Deal& deal,
+                                           int leader) const {
+  const auto [key, check] = keys_of(deal, leader);
+  const auto* end = m_entries + m_num_entries;
+  const auto* it = std::lower_bound(
+      m_entries, end, key,
+      [](const Entry& entry, Zobrist::Key k) { return entry.key < k; });
+  if (it == end or it->key != key or it->check != check) return std::nullopt;
+  return it->value;
+}
+}  // namespace rankup
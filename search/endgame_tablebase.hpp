@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/card_set.hpp"
+#include "rules/file_image.hpp"
+#include "search/double_dummy.hpp"
+#include "search/zobrist.hpp"
+
+namespace rankup {
+/**
+   Solved values of endgame positions, i.e. positions at the start of a trick
+   with a few cards left in each hand.
+
+   During the endgame the remaining cards are known to everyone, as all other
+   cards have been played, and only their distribution among the hands is
+   hidden. So the tablebase is built from sets of remaining cards, solving
+   every distribution of each set among the four hands for every kitty point
+   value asked for, both teams attacking, with DoubleDummySolver.
+
+   Positions are canonicalized before being keyed: seats are rotated to put
+   the leader at seat 0, and folk suits other than the lord suit, which are
+   interchangeable, are relabeled into a canonical order. The key is a 64-bit
+   Zobrist hash of the canonical position, and every entry also stores a
+   32-bit hash of the position computed independently, which a probe checks
+   too. build() fails if two positions have the same key.
+
+   Like RulesTables, a tablebase can be written once into a versioned,
+   checksummed binary file and memory-mapped read-only by every process.
+ */
+class EndgameTablebase : public std::enable_shared_from_this<EndgameTablebase> {
+ public:
+  inline static constexpr std::uint32_t VERSION = 2;
+
+  // the largest number of cards per hand supported by build(). 4 cards per
+  // hand already have 16!/(4!)^4 = 63063000 distributions of distinct cards.
+  inline static constexpr int MAX_HAND_SIZE = 4;
+
+  struct Entry {
+    Zobrist::Key key;
+    std::int32_t value;
+    // a second hash of the position, independent of key
+    std::uint32_t check;
+  };
+  static_assert(sizeof(Entry) == 16);
+
+  /**
+     Solve the positions of every distribution of each set of remainders
+     among the four hands, in parallel.
+
+     @param remainders, sets of the remaining cards, each having the same
+     number of cards for each hand, i.e. a multiple of NUM_SEATS
+     @param kitty_points, the points of the kitty to solve for, each a
+     multiple of 5 in [0, 200]
+     @param num_threads, the number of threads, or 0 for all hardware threads
+
+     @throw std::runtime_error if a set of remainders has a wrong number of
+     cards, if kitty_points has a wrong value, or if two different positions
+     have the same key.
+   */
+  static std::shared_ptr<const EndgameTablebase> build(
+      const Card& lord_card, const std::vector<CardSet>& remainders,
+      const std::vector<int>& kitty_points = {0}, int num_threads = 0);
+
+  /**
+     Memory-map a file written by `write`.
+
+     @throw std::runtime_error if the file cannot be mapped, or if it has a
+     wrong magic, version, size or checksum.
+   */
+  static std::shared_ptr<const EndgameTablebase> load(
+      const std::string& path, bool verify_checksum = true);
+
+  /**
+     @throw std::runtime_error if the file cannot be written.
+   */
+  void write(const std::string& path) const;
+
+  /**
+     @return the points the attackers collect from the position where leader
+     leads a trick with deal.hands left, the same as
+     DoubleDummySolver::solve(deal, leader), or nullopt if the position isn't
+     in the tablebase.
+   */
+  std::optional<int> probe(const Deal& deal, int leader) const;
+
+  std::size_t size() const { return m_num_entries; }
+
+  /**
+     @return the key of the position where leader leads a trick with
+     deal.hands left
+   */
+  static Zobrist::Key key_of(const Deal& deal, int leader);
+
+ private:
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t size;
+    // checksum of everything after the header
+    std::uint64_t checksum;
+    std::uint64_t entries_offset;
+    std::uint64_t num_entries;
+    std::uint64_t padding[2];
+  };
+  static_assert(sizeof(Header) == 64);
+  static_assert(starts_with_file_image_header<Header>());
+
+  // the whole file image, either allocated or memory-mapped
+  std::shared_ptr<const void> m_image;
+  // sorted by key
+  const Entry* m_entries = nullptr;
+  std::size_t m_num_entries = 0;
+
+  EndgameTablebase() = default;
+
+  const Header& header() const {
+    return *static_cast<const Header*>(m_image.get());
+  }
+
+  void attach(std::shared_ptr<const void> image);
+
+  // @return the key and the check of the position, as key_of
+  static std::pair<Zobrist::Key, std::uint32_t> keys_of(const Deal& deal,
+                                                        int leader);
+};
+}  // namespace rankup
@@ -0,0 +1,51 @@
+// Generate the file of an EndgameTablebase, to be memory-mapped with
+// EndgameTablebase::load.
+//
+// Sets of remaining cards are read from stdin, one set per line as
+// Card::index() values separated by spaces, e.g. as collected from the
+// endgames of archived games.
+
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/card_set.hpp"
+#include "search/endgame_tablebase.hpp"
+
+int main(int argc, char** argv) {
+  if (argc != 4) {
+    std::cerr << "Usage: " << argv[0]
+              << " <lord suit 0-4> <lord rank 0-14> <output file> < remainders"
+              << std::endl;
+    return 1;
+  }
+
+  try {
+    const rankup::Card lord_card(
+        static_cast<rankup::Suit>(std::stoi(argv[1])),
+        static_cast<rankup::Rank>(std::stoi(argv[2])));
+
+    std::vector<rankup::CardSet> remainders;
+    for (std::string line; std::getline(std::cin, line);) {
+      std::istringstream in(line);
+      rankup::CardSet remainder;
+      for (int index; in >> index;)
+        remainder.add(rankup::Card::from_index(index));
+      if (!remainder.empty()) remainders.push_back(remainder);
+    }
+
+    // kitty points in steps of 10 cover the common cases
+    std::vector<int> kitty_points;
+    for (int points = 0; points <= 60; points += 10)
+      kitty_points.push_back(points);
+
+    rankup::EndgameTablebase::build(lord_card, remainders, kitty_points)
+        ->write(argv[3]);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,153 @@
+#include "search/ismcts.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "profile/stats.hpp"
+#include "profile/trace.hpp"
+#include "search/deal_sampler.hpp"
+#include "search/move_equivalence.hpp"
+
+namespace rankup {
+namespace {
+// the points normalizing the scores into [0, 1]
+constexpr double MAX_POINTS = 200;
+}  // namespace
+
+Ismcts::Ismcts(const Rules& rules, std::unique_ptr<RolloutPolicy> policy)
+    : m_rules(rules),
+      m_generator(rules),
+      m_policy(std::move(policy)),
+      m_equivalences(rules) {
+  if (!m_policy) m_policy = std::make_unique<GreedyRollout>();
+}
+
+std::vector<Ismcts::MoveStats> Ismcts::search(const CardTracker& tracker,
+                                              const PlayState& state,
+                                              const Options& options) {
+  RANKUP_TRACE_SCOPE("Ismcts::search");
+  const int player = tracker.seat();
+  if (state.finished() or state.seat != player or
+      state.deal.hands[player] != tracker.hand()) {
+    RANKUP_STATS_COUNT(EXCEPTION);
+    throw std::runtime_error(
+        "Ismcts::search called with a position not of the player to play!");
+  }
+  const bool kitty_hidden = state.deal.declarer != player;
+  const DealSampler sampler(tracker, kitty_hidden ? options.kitty_size : 0);
+  return search(sampler, state, options);
+}
+
+std::vector<Ismcts::MoveStats> Ismcts::search(const DealSampler& sampler,
+                                              const PlayState& state,
+                                              const Options& options) {
+  if (state.finished() or sampler.num_bins() < NUM_SEATS) {
+    RANKUP_STATS_COUNT(EXCEPTION);
+    throw std::runtime_error(
+        "Ismcts::search called with a finished position or a sampler not of "
+        "the hands!");
+  }
+  // the budget starts once the sampler is built, and the first iteration
+  // runs whatever the time so that there is a move to return
+  const auto deadline = std::chrono::steady_clock::now() + options.time_budget;
+  const int player = state.seat;
+  const bool kitty_hidden = sampler.num_bins() > NUM_SEATS;
+  std::vector<CardSet> bins;
+  std::mt19937_64 gen(options.seed);
+
+  m_nodes.reset();
+  m_num_iterations = 0;
+  while (options.max_iterations <= 0 or
+         m_num_iterations < static_cast<std::uint64_t>(options.max_iterations)) {
+    if (m_num_iterations > 0 and std::chrono::steady_clock::now() > deadline)
+      break;
+
+    // determinize
+    PlayState determinized(state);
+    sampler.sample(gen, bins);
+    for (int s = 0; s < NUM_SEATS; ++s)
+      if (s != player) determinized.deal.hands[s] = bins[s];
+    if (kitty_hidden) determinized.deal.kitty = bins[NUM_SEATS];
+
+    // select and expand
+    m_path.assign(1, 0);
+    NodeArena::Index node = 0;
+    while (!determinized.finished()) {
+      const auto num_nodes = m_nodes.size();
+      node = select(node, determinized, options, gen);
+      m_path.push_back(node);
+      determinized.play(m_rules, m_nodes.move(node));
+      if (m_nodes.size() > num_nodes) break;
+    }
+
+    // simulate and back up
+    const double points =
+        play_out(m_generator, determinized, *m_policy, gen);
+    const double score = std::min(1.0, points / MAX_POINTS);
+    for (const auto n : m_path) {
+      ++m_nodes[n].visits;
+      m_nodes[n].score += score;
+      m_nodes[n].points += points;
+    }
+    ++m_num_iterations;
+  }
+
+  std::vector<MoveStats> res;
+  for (auto c = m_nodes[0].first_child; c != NodeArena::NONE;
+       c = m_nodes[c].next_sibling) {
+    const auto& child = m_nodes[c];
+    res.push_back({m_nodes.move(c), static_cast<int>(child.visits),
+                   child.visits ? child.points / child.visits : 0});
+  }
+  std::stable_sort(res.begin(), res.end(),
+                   [](const MoveStats& a, const MoveStats& b) {
+                     return a.visits > b.visits;
+                   });
+  return res;
+}
+
+NodeArena::Index Ismcts::select(NodeArena::Index node, const PlayState& state,
+                                const Options& options, std::mt19937_64& gen) {
+  const auto& hand = state.deal.hands[state.seat];
+  m_moves.clear();
+  if (state.round)
+    m_generator.follows(*state.round, hand, m_moves);
+  else
+    m_generator.leads(hand, m_moves);
+  if (options.compress_moves)
+    m_equivalences.get(hand, state.out_of_play()).compress(m_moves);
+
+  // count the availability of the children of legal moves, dropping their
+  // moves to leave the untried ones
+  auto best = NodeArena::NONE;
+  double best_value = -std::numeric_limits<double>::infinity();
+  const bool attacker = is_attacker(state.deal, state.seat);
+  for (auto c = m_nodes[node].first_child; c != NodeArena::NONE;
+       c = m_nodes[c].next_sibling) {
+    auto it = std::find(m_moves.begin(), m_moves.end(), m_nodes.move(c));
+    if (it == m_moves.end()) continue;
+    *it = m_moves.back();
+    m_moves.pop_back();
+
+    auto& child = m_nodes[c];
+    ++child.availability;
+    const double mean = child.score / child.visits;
+    const double value =
+        (attacker ? mean : 1 - mean) +
+        options.exploration *
+            std::sqrt(std::log(child.availability) / child.visits);
+    if (value > best_value) {
+      best = c;
+      best_value = value;
+    }
+  }
+  if (m_moves.empty()) return best;
+
+  // expand an untried move
+  const auto child = m_nodes.add_child(node, m_moves[gen() % m_moves.size()]);
+  m_nodes[child].availability = 1;
+  return child;
+}
+}  // namespace rankup
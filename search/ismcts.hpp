@@ -0,0 +1,113 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/card_tracker.hpp"
+#include "search/deal_sampler.hpp"
+#include "search/move_equivalence.hpp"
+#include "search/moves.hpp"
+#include "search/node_arena.hpp"
+#include "search/play_state.hpp"
+#include "search/rollout.hpp"
+
+namespace rankup {
+/**
+   Information set Monte Carlo tree search of the play of a player, i.e.
+   single-observer ISMCTS.
+
+   Every iteration determinizes the hands hidden from the player, and the
+   kitty unless the player is the declarer, with a DealSampler built from
+   what the CardTracker of the player has seen. It then descends one tree
+   shared by all determinizations, choosing among the children whose moves
+   are legal in the determinization by UCB1 with availability counts,
+   expands one untried move, plays out the rest of the deal with a rollout
+   policy and backs up the points of the attackers, normalized by 200, from
+   the point of view of the seat making each move. The tree lives in a
+   NodeArena reused from one search to the next.
+
+   A search is not thread-safe; use one Ismcts per thread.
+ */
+class Ismcts {
+ public:
+  struct Options {
+    double exploration = 0.7;
+    // the number of iterations, or 0 for no limit other than time
+    int max_iterations = 0;
+    // the time of the iterations, not counting building the DealSampler;
+    // the first iteration runs even if the budget is spent
+    std::chrono::milliseconds time_budget{1000};
+    std::uint64_t seed = 0;
+    // the size of the kitty, sampled if the player isn't the declarer
+    int kitty_size = 8;
+    // whether to try only one move of each class of MoveEquivalence
+    bool compress_moves = false;
+  };
+
+  struct MoveStats {
+    CardSet move;
+    int visits;
+    // the mean points of the attackers after the move
+    double mean_points;
+  };
+
+  /**
+     @param policy, the rollout policy, GreedyRollout if nullptr
+   */
+  explicit Ismcts(const Rules& rules,
+                  std::unique_ptr<RolloutPolicy> policy = nullptr);
+
+  /**
+     Search the move of the player of tracker, who is to play in state.
+     Only the hand of the player and the public parts of state are used.
+
+     @return the statistics of the moves of the player, the most visited
+     first
+
+     @throw std::runtime_error if state is finished, if it isn't the turn of
+     the player, or if the hand of the player in state isn't the one of
+     tracker.
+   */
+  std::vector<MoveStats> search(const CardTracker& tracker,
+                                const PlayState& state,
+                                const Options& options);
+
+  /**
+     Same as above with the hidden cards drawn from sampler, which is to be
+     built from the CardTracker of the player to play in state, e.g. once
+     for several searches of the same position. The kitty is sampled if
+     sampler has a bin for it, whatever options.kitty_size.
+
+     @throw std::runtime_error if state is finished or sampler has fewer
+     bins than seats.
+   */
+  std::vector<MoveStats> search(const DealSampler& sampler,
+                                const PlayState& state,
+                                const Options& options);
+
+  std::uint64_t num_iterations() const { return m_num_iterations; }
+
+  std::size_t num_nodes() const { return m_nodes.size(); }
+
+ private:
+  const Rules& m_rules;
+  MoveGenerator m_generator;
+  std::unique_ptr<RolloutPolicy> m_policy;
+  // kept across searches, as its entries don't depend on the search
+  MoveEquivalenceCache m_equivalences;
+
+  NodeArena m_nodes;
+  std::vector<CardSet> m_moves;
+  std::vector<NodeArena::Index> m_path;
+  std::uint64_t m_num_iterations = 0;
+
+  // @return the child of node chosen for state, possibly a new one
+  NodeArena::Index select(NodeArena::Index node, const PlayState& state,
+                          const Options& options, std::mt19937_64& gen);
+};
+}  // namespace rankup
@@ -0,0 +1,262 @@
+#include "search/kitty_optimizer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#include "profile/stats.hpp"
+#include "profile/trace.hpp"
+#include "rules/hand_structure.hpp"
+#include "search/parallel.hpp"
+
+namespace rankup {
+namespace {
+// the number of combinations enumerated by one task
+constexpr std::uint64_t CHUNK_SIZE = 1 << 12;
+
+bool is_better(const BuryCandidate& a, const BuryCandidate& b) {
+  if (a.score != b.score) return a.score > b.score;
+  // break ties by the cards, so that results don't depend on threading
+  return std::make_pair(a.buried.once(), a.buried.twice()) <
+         std::make_pair(b.buried.once(), b.buried.twice());
+}
+
+// binomial coefficients C(n, k) for k up to max_k
+class Binomials {
+ public:
+  Binomials(int max_n, int max_k)
+      : m_max_k(max_k), m_table((max_n + 1) * (max_k + 1), 0) {
+    for (int n = 0; n <= max_n; ++n) {
+      at(n, 0) = 1;
+      for (int k = 1; k <= std::min(n, max_k); ++k)
+        at(n, k) = at(n - 1, k - 1) + (k <= n - 1 ? at(n - 1, k) : 0);
+    }
+  }
+
+  std::uint64_t operator()(int n, int k) const {
+    if (n < 0 or k < 0 or k > n) return 0;
+    return m_table[n * (m_max_k + 1) + k];
+  }
+
+ private:
+  int m_max_k;
+  std::vector<std::uint64_t> m_table;
+
+  std::uint64_t& at(int n, int k) { return m_table[n * (m_max_k + 1) + k]; }
+};
+
+/**
+   The candidates dominated by another one, i.e. those burying a lord while
+   enough folk cards are left, and those burying a single folk card while
+   keeping a weaker single of the same suit and the same points. The latter
+   means the buried singles of each such group are its weakest ones.
+ */
+class Dominance {
+ public:
+  Dominance(const Rules& rules, const CardSet& hand, int num_to_bury) {
+    std::uint64_t lords = 0;
+    int num_folk = 0;
+    std::map<std::pair<Suit, int>, std::vector<Card>> groups;
+    for (const auto& card : hand.to_vector()) {
+      const auto suit = rules.lorded_suit(card);
+      if (suit == Suit::J) {
+        lords |= CardSet::bit(card);
+        continue;
+      }
+      ++num_folk;
+      if (hand.count(card) == 1)
+        groups[{suit, points_of(card)}].push_back(card);
+    }
+    if (num_folk >= num_to_bury) m_lords = lords;
+
+    for (auto& [key, cards] : groups) {
+      std::sort(cards.begin(), cards.end(),
+                [&rules](const Card& a, const Card& b) {
+                  return rules.strength(a) < rules.strength(b);
+                });
+      Group group;
+      for (const auto& card : cards) {
+        group.prefixes.push_back(group.mask);
+        group.mask |= CardSet::bit(card);
+      }
+      group.prefixes.push_back(group.mask);
+      m_groups.push_back(std::move(group));
+    }
+  }
+
+  bool is_dominated(const CardSet& buried) const {
+    if (buried.once() & m_lords) return true;
+    for (const auto& group : m_groups) {
+      const auto in_group = buried.once() & group.mask;
+      if (in_group != group.prefixes[__builtin_popcountll(in_group)])
+        return true;
+    }
+    return false;
+  }
+
+ private:
+  struct Group {
+    std::uint64_t mask = 0;
+    // prefixes[i] is the mask of the i weakest cards
+    std::vector<std::uint64_t> prefixes;
+  };
+
+  std::uint64_t m_lords = 0;
+  std::vector<Group> m_groups;
+};
+
+// keeps the best k candidates in a heap whose front is the worst of them
+class TopK {
+ public:
+  explicit TopK(int k) : m_k(k) {}
+
+  void offer(const BuryCandidate& candidate) {
+    if (m_k <= 0) return;
+    if (static_cast<int>(m_heap.size()) < m_k) {
+      m_heap.push_back(candidate);
+      std::push_heap(m_heap.begin(), m_heap.end(), is_better);
+    } else if (is_better(candidate, m_heap.front())) {
+      std::pop_heap(m_heap.begin(), m_heap.end(), is_better);
+      m_heap.back() = candidate;
+      std::push_heap(m_heap.begin(), m_heap.end(), is_better);
+    }
+  }
+
+  const std::vector<BuryCandidate>& data() const { return m_heap; }
+
+ private:
+  int m_k;
+  std::vector<BuryCandidate> m_heap;
+};
+}  // namespace
+
+double HeuristicBuryEvaluator::score(const Rules& rules, const CardSet& kept,
+                                     const CardSet& buried) const {
+  double res = 0;
+
+  for (const auto& card : buried.to_vector()) {
+    const int strength = rules.strength(card);
+    if (rules.lorded_suit(card) == Suit::J)
+      res -= m_weights.buried_lord + strength;
+    else
+      res -= m_weights.buried_strength * strength;
+  }
+  res -= m_weights.buried_point * buried.points();
+
+  const auto cards = kept.to_vector();
+  bool has_suit[4] = {false, false, false, false};
+  for (const auto& card : cards) {
+    const auto suit = rules.lorded_suit(card);
+    if (suit != Suit::J) has_suit[static_cast<int>(suit)] = true;
+  }
+  for (int s = 0; s < 4; ++s) {
+    const auto suit = static_cast<Suit>(s);
+    if (suit != rules.lord_card().suit() and !has_suit[s])
+      res += m_weights.void_suit;
+  }
+
+  const HandStructure structure(rules, cards);
+  for (int s = 0; s < 5; ++s) {
+    const auto& fmt = structure.composition(static_cast<Suit>(s)).format();
+    for (int8_t axle = 1; axle <= fmt.total_num_cards() / 2; ++axle) {
+      const int num_pairs = axle * fmt.get_count_at_or_0(axle);
+      res += m_weights.kept_pair * num_pairs;
+      if (axle >= 2) res += m_weights.kept_tractor_pair * num_pairs;
+    }
+  }
+  return res;
+}
+
+BuryResult optimize_bury(const Rules& rules, const CardSet& hand,
+                         const BuryEvaluator& evaluator,
+                         const BuryOptions& options) {
+  RANKUP_TRACE_SCOPE("optimize_bury");
+  const int k = options.num_to_bury;
+  const int n = hand.size();
+  if (k < 0 or k > n) {
+    RANKUP_STATS_COUNT(EXCEPTION);
+    throw std::runtime_error("optimize_bury called with too few cards!");
+  }
+  const auto deadline = std::chrono::steady_clock::now() + options.time_budget;
+
+  // positions of the cards of hand, both copies of a card being adjacent.
+  // Combinations choosing the second copy but not the first are skipped, so
+  // that every candidate is enumerated once.
+  const auto cards = hand.to_vector();
+  std::vector<CardSet> positions(n);
+  for (int i = 0; i < n; ++i) {
+    const auto bit = CardSet::bit(cards[i]);
+    const bool second = i > 0 and cards[i] == cards[i - 1];
+    positions[i] = second ? CardSet(0, bit) : CardSet(bit, 0);
+  }
+
+  const Binomials binomials(n, k);
+  const auto total = binomials(n, k);
+  const Dominance dominance(rules, hand, k);
+
+  const int num_threads = resolve_num_threads(options.num_threads);
+  std::vector<TopK> best(num_threads, TopK(options.top_k));
+  std::vector<std::uint64_t> num_evaluated(num_threads, 0);
+  std::atomic<bool> timed_out{false};
+
+  const auto num_chunks = (total + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  parallel_for(num_chunks, num_threads, [&](std::size_t chunk, int thread) {
+    if (timed_out.load(std::memory_order_relaxed)) return;
+    if (std::chrono::steady_clock::now() > deadline) {
+      timed_out = true;
+      return;
+    }
+
+    // unrank the first combination of the chunk in lexicographic order
+    std::uint64_t rank = chunk * CHUNK_SIZE;
+    std::vector<int> combination(k);
+    for (int i = 0, x = 0; i < k; ++i, ++x) {
+      for (;; ++x) {
+        const auto count = binomials(n - 1 - x, k - 1 - i);
+        if (rank < count) break;
+        rank -= count;
+      }
+      combination[i] = x;
+    }
+
+    const auto end = std::min(total, (chunk + 1) * CHUNK_SIZE);
+    for (auto r = chunk * CHUNK_SIZE; r < end; ++r) {
+      std::uint64_t once = 0;
+      std::uint64_t twice = 0;
+      for (const auto i : combination) {
+        once |= positions[i].once();
+        twice |= positions[i].twice();
+      }
+      const CardSet buried(once, twice);
+      if ((twice & ~once) == 0 and
+          !(options.prune_dominated and dominance.is_dominated(buried))) {
+        auto kept = hand;
+        kept -= buried;
+        best[thread].offer({buried, evaluator.score(rules, kept, buried)});
+        ++num_evaluated[thread];
+      }
+
+      // advance to the next combination
+      int i = k - 1;
+      while (i >= 0 and combination[i] == n - k + i) --i;
+      if (i < 0) break;
+      ++combination[i];
+      for (int j = i + 1; j < k; ++j) combination[j] = combination[j - 1] + 1;
+    }
+  });
+
+  BuryResult res;
+  for (int t = 0; t < num_threads; ++t) {
+    const auto& data = best[t].data();
+    res.best.insert(res.best.end(), data.begin(), data.end());
+    res.num_evaluated += num_evaluated[t];
+  }
+  std::sort(res.best.begin(), res.best.end(), is_better);
+  if (static_cast<int>(res.best.size()) > options.top_k)
+    res.best.resize(std::max(options.top_k, 0));
+  res.complete = !timed_out;
+  return res;
+}
+}  // namespace rankup
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+
+namespace rankup {
+/**
+   Scores a choice of cards to bury in the kitty, the higher the better.
+   Implementations must be thread-safe, as score() is called concurrently.
+ */
+class BuryEvaluator {
+ public:
+  virtual ~BuryEvaluator() = default;
+
+  /**
+     @param kept, the cards kept in the hand of the declarer
+     @param buried, the cards buried in the kitty
+   */
+  virtual double score(const Rules& rules, const CardSet& kept,
+                       const CardSet& buried) const = 0;
+};
+
+/**
+   A linear combination of features of the kept hand and the kitty.
+ */
+class HeuristicBuryEvaluator : public BuryEvaluator {
+ public:
+  struct Weights {
+    // per folk suit left void
+    double void_suit = 20;
+    // per point buried, which the attackers win multiplied if they win the
+    // last trick
+    double buried_point = 1;
+    // per buried lord, plus its strength
+    double buried_lord = 30;
+    // per strength of buried folk cards, so that weak cards are buried first
+    double buried_strength = 1;
+    // per pair kept, as parsed by HandStructure
+    double kept_pair = 6;
+    // per pair kept as part of a tractor, on top of kept_pair
+    double kept_tractor_pair = 6;
+  };
+
+  HeuristicBuryEvaluator() = default;
+  explicit HeuristicBuryEvaluator(const Weights& weights)
+      : m_weights(weights) {}
+
+  double score(const Rules& rules, const CardSet& kept,
+               const CardSet& buried) const override;
+
+ private:
+  Weights m_weights;
+};
+
+struct BuryCandidate {
+  CardSet buried;
+  double score;
+};
+
+struct BuryOptions {
+  int num_to_bury = 8;
+  // the number of best candidates returned
+  int top_k = 10;
+  std::chrono::milliseconds time_budget{1000};
+  // Skip candidates that no sensible evaluator prefers: burying a lord
+  // while enough folk cards are left, or burying a single folk card while
+  // keeping a weaker single of the same suit with the same points.
+  bool prune_dominated = true;
+  // the number of threads, or 0 for all hardware threads
+  int num_threads = 0;
+};
+
+struct BuryResult {
+  // the best candidates, sorted by score from high to low
+  std::vector<BuryCandidate> best;
+  std::uint64_t num_evaluated = 0;
+  // false if the time budget ran out before all candidates were considered
+  bool complete = true;
+};
+
+/**
+   Choose the cards to bury from the hand of the declarer including the
+   kitty, e.g. 8 out of 33 cards. Candidates are enumerated in parallel as
+   combinations of the cards of hand, with copies of the same card counted
+   once.
+
+   @throw std::runtime_error if hand has fewer cards than
+   options.num_to_bury.
+ */
+BuryResult optimize_bury(const Rules& rules, const CardSet& hand,
+                         const BuryEvaluator& evaluator,
+                         const BuryOptions& options = {});
+}  // namespace rankup
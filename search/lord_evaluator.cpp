@@ -0,0 +1,125 @@
+#include "search/lord_evaluator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "common/hash.hpp"
+#include "profile/stats.hpp"
+#include "profile/trace.hpp"
+#include "search/moves.hpp"
+#include "search/parallel.hpp"
+#include "search/play_state.hpp"
+#include "search/rollout.hpp"
+
+namespace rankup {
+namespace {
+constexpr int KITTY_SIZE = 8;
+
+// the state of a thread, reused across samples
+struct Player {
+  std::unique_ptr<Rules> rules;
+  std::unique_ptr<MoveGenerator> generator;
+};
+}  // namespace
+
+LordEvaluator::LordEvaluator(std::shared_ptr<const RulesTables> tables)
+    : m_tables(std::move(tables)) {}
+
+std::vector<LordEvaluation> LordEvaluator::evaluate(
+    const CardSet& hand, const std::vector<Card>& candidates,
+    const Options& options) const {
+  RANKUP_TRACE_SCOPE("LordEvaluator::evaluate");
+  if (hand.size() > HAND_SIZE) {
+    RANKUP_STATS_COUNT(EXCEPTION);
+    throw std::runtime_error("LordEvaluator::evaluate called with too many "
+                             "cards!");
+  }
+  const auto deadline = std::chrono::steady_clock::now() + options.time_budget;
+
+  // the unseen cards
+  std::vector<Card> unseen;
+  for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+    const auto card = Card::from_index(i);
+    for (int copy = hand.count(card); copy < NUM_DECKS; ++copy)
+      unseen.push_back(card);
+  }
+
+  const int num_candidates = candidates.size();
+  const int num_threads = resolve_num_threads(options.num_threads);
+  std::vector<std::vector<Player>> players(num_threads);
+  std::vector<std::vector<Card>> decks(num_threads);
+  std::vector<GreedyRollout> policies(num_threads);
+  // the points of each sample and candidate
+  std::vector<int> points(options.num_samples * num_candidates, 0);
+  std::vector<char> done(options.num_samples, 0);
+  std::atomic<bool> timed_out{false};
+
+  parallel_for(options.num_samples, num_threads, [&](std::size_t sample,
+                                                     int thread) {
+    if (timed_out.load(std::memory_order_relaxed)) return;
+    if (std::chrono::steady_clock::now() > deadline) {
+      timed_out = true;
+      return;
+    }
+
+    auto& own = players[thread];
+    if (own.empty()) {
+      for (const auto& lord_card : candidates) {
+        Player player;
+        player.rules = m_tables ? std::make_unique<Rules>(lord_card, m_tables)
+                                : std::make_unique<Rules>(lord_card);
+        player.generator = std::make_unique<MoveGenerator>(*player.rules);
+        own.push_back(std::move(player));
+      }
+    }
+
+    auto& deck = decks[thread];
+    deck = unseen;
+    std::mt19937_64 gen(mix64(options.seed + sample + 1));
+    std::shuffle(deck.begin(), deck.end(), gen);
+
+    Deal dealt;
+    dealt.declarer = 0;
+    dealt.hands[0] = hand;
+    auto it = deck.begin();
+    for (int s = 0; s < NUM_SEATS; ++s) {
+      while (dealt.hands[s].size() < HAND_SIZE) dealt.hands[s].add(*it++);
+    }
+    for (int k = 0; k < KITTY_SIZE; ++k) dealt.kitty.add(*it++);
+
+    for (int c = 0; c < num_candidates; ++c) {
+      PlayState state;
+      state.deal = dealt;
+      state.deal.lord_card = candidates[c];
+      state.seat = dealt.declarer;
+      points[sample * num_candidates + c] =
+          play_out(*own[c].generator, state, policies[thread], gen);
+    }
+    done[sample] = 1;
+  });
+
+  std::vector<LordEvaluation> res(num_candidates);
+  for (int c = 0; c < num_candidates; ++c) {
+    auto& eval = res[c];
+    eval.lord_card = candidates[c];
+    double sum = 0;
+    double sum_sq = 0;
+    for (int sample = 0; sample < options.num_samples; ++sample) {
+      if (!done[sample]) continue;
+      const double p = points[sample * num_candidates + c];
+      sum += p;
+      sum_sq += p * p;
+      ++eval.num_samples;
+    }
+    if (eval.num_samples > 0) {
+      eval.mean_points = sum / eval.num_samples;
+      eval.stddev_points = std::sqrt(std::max(
+          0.0, sum_sq / eval.num_samples - eval.mean_points * eval.mean_points));
+    }
+  }
+  return res;
+}
+}  // namespace rankup
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+
+namespace rankup {
+class RulesTables;
+
+struct LordEvaluation {
+  Card lord_card = Card(Suit::J, Rank::_W);
+  // the mean points of the attackers over the simulated deals, the lower the
+  // better for the declarer
+  double mean_points = 0;
+  double stddev_points = 0;
+  int num_samples = 0;
+};
+
+/**
+   Monte Carlo evaluator of the lord cards a player may declare.
+
+   The player declares from seat 0 holding a partial or full hand. For each
+   sample, the unseen cards are dealt at random to fill up the hands and the
+   kitty, and the deal is played out under the Rules of every candidate lord
+   card by GreedyRollout, with the declarer leading the first trick.
+   Candidates are evaluated on the same sampled deals to lower the variance
+   of their differences. The kitty is left as dealt.
+ */
+class LordEvaluator {
+ public:
+  inline static constexpr int HAND_SIZE = 25;
+
+  struct Options {
+    int num_samples = 256;
+    std::chrono::milliseconds time_budget{1000};
+    // the number of threads, or 0 for all hardware threads
+    int num_threads = 0;
+    // samples depend on seed only, not on the number of threads
+    std::uint64_t seed = 0;
+  };
+
+  /**
+     @param tables, if not nullptr, used to construct the Rules of each
+     candidate cheaply
+   */
+  explicit LordEvaluator(std::shared_ptr<const RulesTables> tables = nullptr);
+
+  /**
+     @return the evaluation of each candidate, in the same order. Samples
+     are only started before the deadline, so all candidates have the same
+     number of samples, which is 0 if the time budget is already over.
+
+     @throw std::runtime_error if hand has more than HAND_SIZE cards.
+   */
+  std::vector<LordEvaluation> evaluate(const CardSet& hand,
+                                       const std::vector<Card>& candidates,
+                                       const Options& options) const;
+
+  std::vector<LordEvaluation> evaluate(
+      const CardSet& hand, const std::vector<Card>& candidates) const {
+    return evaluate(hand, candidates, Options());
+  }
+
+ private:
+  std::shared_ptr<const RulesTables> m_tables;
+};
+}  // namespace rankup
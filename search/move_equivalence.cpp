@@ -0,0 +1,153 @@
+#include "search/move_equivalence.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "common/hash.hpp"
+#include "common/strength_mask.hpp"
+#include "profile/trace.hpp"
+
+namespace rankup {
+MoveEquivalence::MoveEquivalence(const Rules& rules, const CardSet& hand,
+                                 const CardSet& played)
+    : m_hand(hand) {
+  // the kinds of cards of each lorded suit and strength, and whether one of
+  // them has a copy still in play outside the hand
+  std::array<std::array<std::uint64_t, NUM_STRENGTHS>, NUM_LORDED_SUITS>
+      kinds{};
+  std::array<std::array<bool, NUM_STRENGTHS>, NUM_LORDED_SUITS> outside{};
+  for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+    const auto card = Card::from_index(i);
+    m_strength[i] = rules.strength(card);
+    m_suit[i] = rules.lorded_suit(card);
+    const int s = static_cast<int>(m_suit[i]);
+    kinds[s][m_strength[i]] |= std::uint64_t(1) << i;
+    if (hand.count(card) + played.count(card) < NUM_DECKS)
+      outside[s][m_strength[i]] = true;
+  }
+
+  // walk up the strengths of each lorded suit, starting a new group at every
+  // strength with a card still in play outside the hand. The cards of such a
+  // strength make a group of their own, as the cards outside tie with them.
+  int16_t group = 0;
+  for (int s = 0; s < NUM_LORDED_SUITS; ++s) {
+    ++group;
+    for (int strength = 0; strength < NUM_STRENGTHS; ++strength) {
+      if (outside[s][strength]) ++group;
+      for (auto m = kinds[s][strength]; m; m &= m - 1) {
+        const int i = __builtin_ctzll(m);
+        m_class[i] = 3 * group + points_of(Card::from_index(i)) / 5;
+      }
+      if (outside[s][strength]) ++group;
+    }
+  }
+}
+
+bool MoveEquivalence::Signature::operator==(const Signature& other) const {
+  return std::equal(values.begin(), values.begin() + size,
+                    other.values.begin(), other.values.begin() + other.size);
+}
+
+bool MoveEquivalence::Signature::operator<(const Signature& other) const {
+  return std::lexicographical_compare(values.begin(), values.begin() + size,
+                                      other.values.begin(),
+                                      other.values.begin() + other.size);
+}
+
+void MoveEquivalence::signature(const CardSet& move, Signature& res) const {
+  res.size = 0;
+  append_signature(move, res);
+  res.push_back(-2);
+  auto rest = m_hand;
+  rest -= move;
+  append_signature(rest, res);
+}
+
+void MoveEquivalence::append_signature(const CardSet& cards,
+                                       Signature& res) const {
+  const int first = res.size;
+  for (auto m = cards.once(); m; m &= m - 1) {
+    const int i = __builtin_ctzll(m);
+    res.push_back(4 * m_class[i] + 1 + ((cards.twice() >> i) & 1));
+  }
+  std::sort(res.values.begin() + first, res.values.begin() + res.size);
+
+  // the tractors, by lorded suit, length and class of their lowest pair
+  res.push_back(-1);
+  for (int s = 0; s < NUM_LORDED_SUITS; ++s) {
+    std::array<int16_t, NUM_STRENGTHS + 1> lowest;
+    lowest.fill(-1);
+    for (auto m = cards.twice(); m; m &= m - 1) {
+      const int i = __builtin_ctzll(m);
+      if (static_cast<int>(m_suit[i]) != s) continue;
+      auto& c = lowest[m_strength[i]];
+      if (c < 0 or m_class[i] < c) c = m_class[i];
+    }
+    for (int start = 0; start < NUM_STRENGTHS; ++start) {
+      if (lowest[start] < 0 or (start > 0 and lowest[start - 1] >= 0))
+        continue;
+      int length = 1;
+      while (lowest[start + length] >= 0) ++length;
+      if (length < 2) continue;
+      res.push_back(s);
+      res.push_back(length);
+      res.push_back(lowest[start]);
+    }
+  }
+}
+
+bool MoveEquivalence::equivalent(const CardSet& a, const CardSet& b) const {
+  if (a.size() != b.size()) return false;
+  Signature sa, sb;
+  signature(a, sa);
+  signature(b, sb);
+  return sa == sb;
+}
+
+void MoveEquivalence::compress(std::vector<CardSet>& moves) const {
+  RANKUP_TRACE_SCOPE("MoveEquivalence::compress");
+  std::vector<Signature> signatures(moves.size());
+  for (std::size_t i = 0; i < moves.size(); ++i)
+    signature(moves[i], signatures[i]);
+
+  std::vector<std::size_t> order(moves.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+    if (signatures[a] != signatures[b]) return signatures[a] < signatures[b];
+    return a < b;
+  });
+  std::vector<char> keep(moves.size(), 0);
+  for (std::size_t k = 0; k < order.size(); ++k) {
+    if (k == 0 or signatures[order[k]] != signatures[order[k - 1]])
+      keep[order[k]] = 1;
+  }
+
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < moves.size(); ++i)
+    if (keep[i]) moves[n++] = moves[i];
+  moves.resize(n);
+}
+
+MoveEquivalenceCache::MoveEquivalenceCache(const Rules& rules,
+                                           std::size_t num_slots)
+    : m_rules(rules) {
+  std::size_t size = 1;
+  while (2 * size <= num_slots) size *= 2;
+  m_slots.resize(size);
+  m_mask = size - 1;
+}
+
+const MoveEquivalence& MoveEquivalenceCache::get(const CardSet& hand,
+                                                 const CardSet& played) {
+  const auto hash =
+      mix64(hand.once() ^
+            mix64(hand.twice() ^ mix64(played.once() ^ mix64(played.twice()))));
+  auto& slot = m_slots[hash & m_mask];
+  if (!slot.equivalence or slot.hand != hand or slot.played != played) {
+    slot.hand = hand;
+    slot.played = played;
+    slot.equivalence.emplace(m_rules, hand, played);
+  }
+  return *slot.equivalence;
+}
+}  // namespace rankup
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+
+namespace rankup {
+/**
+   Equivalence of the plays of a hand once the cards between them are out of
+   play, e.g. a 9 and a jack of a suit once both 10s are played: whatever
+   beats one beats the other, and neither beats anything the other doesn't.
+
+   Cards of a hand are equivalent if they have the same lorded suit and
+   points, and every card of a strength between theirs, including theirs, is
+   either in the hand or out of play. Plays are equivalent if they have the
+   same numbers of cards of each class and the same pairs and tractors,
+   where tractors depend on the exact adjacency of strengths, as in
+   MoveGenerator::leads, rather than on classes: after both 10s are played,
+   pairs of 9s and jacks are not a tractor while pairs of 8s and 9s are.
+   They must also leave the same pairs and tractors in the rest of the hand:
+   from 9-9-J, once the 10s and the other jack are played, leading the jack
+   keeps the pair of 9s while leading a 9 breaks it.
+ */
+class MoveEquivalence {
+ public:
+  /**
+     @param played, the cards out of play. The cards winning the current
+     trick are still in play, as a follow may have to beat them.
+   */
+  MoveEquivalence(const Rules& rules, const CardSet& hand,
+                  const CardSet& played);
+
+  /**
+     @return the class of card, which must be in the hand
+   */
+  int16_t class_of(const Card& card) const { return m_class[card.index()]; }
+
+  bool equivalent(const CardSet& a, const CardSet& b) const;
+
+  /**
+     Keep the first move of each class of moves, in order.
+   */
+  void compress(std::vector<CardSet>& moves) const;
+
+ private:
+  // for the move and then the rest of the hand, the sorted numbers of cards
+  // of each class, a separator and the tractors: at most one value per kind
+  // of card and three per tractor of at least two pairs, plus separators
+  struct Signature {
+    static constexpr int CAPACITY =
+        2 * (NUM_CARD_KINDS + 1 + 3 * (NUM_CARD_KINDS / 2)) + 1;
+
+    std::array<int16_t, CAPACITY> values;
+    int size = 0;
+
+    void push_back(int16_t value) { values[size++] = value; }
+
+    bool operator==(const Signature& other) const;
+    bool operator!=(const Signature& other) const { return !(*this == other); }
+    bool operator<(const Signature& other) const;
+  };
+
+  CardSet m_hand;
+  std::array<int16_t, NUM_CARD_KINDS> m_class{};
+  std::array<int8_t, NUM_CARD_KINDS> m_strength{};
+  std::array<Suit, NUM_CARD_KINDS> m_suit{};
+
+  void signature(const CardSet& move, Signature& res) const;
+
+  // append the part of the signature of cards, a move or a rest of the hand
+  void append_signature(const CardSet& cards, Signature& res) const;
+};
+
+/**
+   A direct-mapped cache of the MoveEquivalence of hands by the cards out of
+   play. A tree search meets the same hand with the same cards out of play at
+   every selection of a node of the searching player, and at many of those of
+   the others late in a deal, so the classes are built about once per node
+   rather than once per selection. Not thread-safe; use one cache per thread.
+ */
+class MoveEquivalenceCache {
+ public:
+  /**
+     @param num_slots, rounded down to a power of two, at least 1
+   */
+  explicit MoveEquivalenceCache(const Rules& rules,
+                                std::size_t num_slots = 1 << 10);
+
+  /**
+     @return the MoveEquivalence of hand and played, valid until the next
+     call
+   */
+  const MoveEquivalence& get(const CardSet& hand, const CardSet& played);
+
+ private:
+  struct Slot {
+    CardSet hand;
+    CardSet played;
+    std::optional<MoveEquivalence> equivalence;
+  };
+
+  const Rules& m_rules;
+  std::vector<Slot> m_slots;
+  std::size_t m_mask;
+};
+}  // namespace rankup
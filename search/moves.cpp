@@ -0,0 +1,112 @@
+#include "search/moves.hpp"
+
+#include "common/strength_mask.hpp"
+
+namespace rankup {
+MoveGenerator::MoveGenerator(const Rules& rules) : m_rules(&rules) {
+  for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+    const auto card = Card::from_index(i);
+    m_masks[static_cast<int>(rules.lorded_suit(card))] |= CardSet::bit(card);
+  }
+}
+
+void MoveGenerator::leads(const CardSet& hand,
+                          std::vector<CardSet>& moves) const {
+  for (int s = 0; s < NUM_LORDED_SUITS; ++s) {
+    const auto cards = cards_of(hand, static_cast<Suit>(s));
+
+    for (auto m = cards.once(); m; m &= m - 1) {
+      const auto card = Card::from_index(__builtin_ctzll(m));
+      moves.emplace_back(CardSet::bit(card), 0);
+    }
+
+    // pairs, keyed by strength. Minor lords may put several pairs on the
+    // same strength, any one of which can be part of a tractor.
+    std::array<std::uint64_t, NUM_STRENGTHS> pairs_at{};
+    for (auto m = cards.twice(); m; m &= m - 1) {
+      const auto card = Card::from_index(__builtin_ctzll(m));
+      const auto b = CardSet::bit(card);
+      moves.emplace_back(b, b);
+      pairs_at[m_rules->strength(card)] |= b;
+    }
+
+    // tractors of `length` pairs starting at strength `start`, choosing one
+    // pair per strength
+    std::uint64_t tractor = 0;
+    auto add_tractors = [&](auto&& self, int start, int length, int i) {
+      if (i == length) {
+        moves.emplace_back(tractor, tractor);
+        return;
+      }
+      for (auto m = pairs_at[start + i]; m; m &= m - 1) {
+        const auto b = m & -m;
+        tractor |= b;
+        self(self, start, length, i + 1);
+        tractor &= ~b;
+      }
+    };
+    for (int start = 0; start < 16; ++start) {
+      if (!pairs_at[start]) continue;
+      for (int end = start + 1; end < 16 and pairs_at[end]; ++end)
+        add_tractors(add_tractors, start, end - start + 1, 0);
+    }
+  }
+}
+
+void MoveGenerator::throws(const CardSet& hand,
+                           const std::vector<std::vector<Card>>& others,
+                           std::vector<CardSet>& moves) const {
+  for (int s = 0; s < NUM_LORDED_SUITS; ++s) {
+    auto cards = cards_of(hand, static_cast<Suit>(s));
+    if (cards.size() < 2) continue;
+
+    for (auto failed = m_rules->check_throw(cards.to_vector(), others);
+         !failed.empty();
+         failed = m_rules->check_throw(cards.to_vector(), others))
+      cards -= CardSet(failed);
+
+    int num_components = 0;
+    m_rules->start_round_with(cards.to_vector())
+        .winning_composition()
+        .for_each_component([&num_components](int8_t, int8_t) {
+          ++num_components;
+        });
+    if (num_components > 1) moves.push_back(cards);
+  }
+}
+
+void MoveGenerator::follows(const RoundRules& round, const CardSet& hand,
+                            std::vector<CardSet>& moves) const {
+  const auto& format = round.format();
+  const int num_cards = format.total_num_cards();
+  const auto suited = cards_of(hand, *format.suit());
+
+  if (suited.size() <= num_cards) {
+    // all cards of the suit, filled up with any other cards
+    auto others = hand;
+    others -= suited;
+    for_each_subset(others, num_cards - suited.size(),
+                    [&moves, &suited](const CardSet& filler) {
+                      auto move = suited;
+                      move += filler;
+                      moves.push_back(move);
+                    });
+    return;
+  }
+
+  const auto required = round.get_required_format(hand.to_vector());
+  if (required.get_count_at_or_0(0) == required.total_num_cards()) {
+    // only singles are required, which any cards of the suit satisfy
+    for_each_subset(suited, num_cards,
+                    [&moves](const CardSet& move) { moves.push_back(move); });
+    return;
+  }
+
+  for_each_subset(suited, num_cards, [this, &moves,
+                                      &required](const CardSet& move) {
+    if (required.is_covered_by(
+            m_rules->start_round_with(move.to_vector()).format()))
+      moves.push_back(move);
+  });
+}
+}  // namespace rankup
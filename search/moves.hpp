@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+
+namespace rankup {
+/**
+   Generator of the legal plays of a hand under some Rules, each play being a
+   CardSet. Plays made of the same cards are generated once.
+ */
+class MoveGenerator {
+ public:
+  explicit MoveGenerator(const Rules& rules);
+
+  const Rules& rules() const { return *m_rules; }
+
+  /**
+     @return the bitmask over Card::index() of the cards of lorded_suit
+   */
+  std::uint64_t mask(Suit lorded_suit) const {
+    return m_masks[static_cast<int>(lorded_suit)];
+  }
+
+  /**
+     @return the cards of hand of lorded_suit
+   */
+  CardSet cards_of(const CardSet& hand, Suit lorded_suit) const {
+    return CardSet(hand.once() & mask(lorded_suit),
+                   hand.twice() & mask(lorded_suit));
+  }
+
+  /**
+     Append to moves every lead of a single component, i.e. every single,
+     pair and tractor of hand. Throws of several components are not
+     generated, since their legality depends on the other hands, see
+     throws().
+   */
+  void leads(const CardSet& hand, std::vector<CardSet>& moves) const;
+
+  /**
+     Append to moves, for each suit in which hand has several components, a
+     throw of them settled by Rules::check_throw against others, the entire
+     cards of the other players. The throw of all the cards of the suit is
+     played as the component returned when it fails, which leads() already
+     generates, so the throw is tried again without that component until it
+     stands. The throw that stands is appended if it still has several
+     components.
+   */
+  void throws(const CardSet& hand,
+              const std::vector<std::vector<Card>>& others,
+              std::vector<CardSet>& moves) const;
+
+  /**
+     Append to moves every legal follow to round from hand. A follow has as
+     many cards as the first cards of round and as many cards of the led suit
+     as possible. If the hand has more cards of the led suit than needed, the
+     follow must also satisfy RoundRules::get_required_format.
+   */
+  void follows(const RoundRules& round, const CardSet& hand,
+               std::vector<CardSet>& moves) const;
+
+ private:
+  const Rules* m_rules;
+  std::array<std::uint64_t, NUM_LORDED_SUITS> m_masks{};
+};
+}  // namespace rankup
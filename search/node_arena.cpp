@@ -0,0 +1,70 @@
+#include "search/node_arena.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "profile/stats.hpp"
+
+namespace rankup {
+NodeArena::NodeArena(std::size_t capacity)
+    : m_nodes(std::max<std::size_t>(1, capacity)),
+      m_moves(m_nodes.size()) {
+  reset();
+}
+
+void NodeArena::reset() {
+  m_size = 1;
+  m_nodes[0] = Node();
+  m_moves[0] = CardSet();
+}
+
+NodeArena::Index NodeArena::allocate(std::size_t n) {
+  if (m_size + n >= NONE) {
+    RANKUP_STATS_COUNT(EXCEPTION);
+    throw std::runtime_error("NodeArena grown past the maximum size!");
+  }
+  const auto first = m_size;
+  m_size += n;
+  if (m_size > m_nodes.size()) {
+    const auto capacity = std::max(m_size, 2 * m_nodes.size());
+    m_nodes.resize(capacity);
+    m_moves.resize(capacity);
+  }
+  return first;
+}
+
+NodeArena::Index NodeArena::add_child(Index parent, const CardSet& move) {
+  const auto child = allocate(1);
+  m_nodes[child] = Node();
+  m_nodes[child].next_sibling = m_nodes[parent].first_child;
+  m_moves[child] = move;
+  m_nodes[parent].first_child = child;
+  return child;
+}
+
+NodeArena::Index NodeArena::expand(Index parent,
+                                   const std::vector<CardSet>& moves) {
+  if (m_nodes[parent].expanded()) {
+    RANKUP_STATS_COUNT(EXCEPTION);
+    throw std::runtime_error("NodeArena::expand called on an expanded node!");
+  }
+  if (moves.empty()) return NONE;
+  const auto first = allocate(moves.size());
+  for (std::size_t i = 0; i < moves.size(); ++i) {
+    m_nodes[first + i] = Node();
+    m_nodes[first + i].next_sibling =
+        i + 1 < moves.size() ? first + i + 1 : NONE;
+    m_moves[first + i] = moves[i];
+  }
+  m_nodes[parent].first_child = first;
+  return first;
+}
+
+NodeArena::Index NodeArena::find_child(Index parent,
+                                       const CardSet& move) const {
+  for (auto c = m_nodes[parent].first_child; c != NONE;
+       c = m_nodes[c].next_sibling)
+    if (m_moves[c] == move) return c;
+  return NONE;
+}
+}  // namespace rankup
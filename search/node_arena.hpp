@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "common/card_set.hpp"
+
+namespace rankup {
+/**
+   A pool of the nodes of one search tree, stored contiguously and reused
+   from one search to the next.
+
+   Nodes are compact records of 32 bytes holding the statistics of a move
+   and links to its first child and next sibling, so that children can be
+   added one at a time, as ISMCTS does when a determinization makes a new
+   move legal, or all at once by expand(), which allocates them
+   contiguously. The moves, which a selection reads only to match the legal
+   moves, are kept in a parallel array indexed like the nodes. reset()
+   empties the pool in O(1) while keeping its memory, so a search allocates
+   nothing once the pool has grown to the size of its trees.
+ */
+class NodeArena {
+ public:
+  using Index = std::uint32_t;
+  static constexpr Index NONE = std::numeric_limits<Index>::max();
+
+  struct Node {
+    Index first_child = NONE;
+    Index next_sibling = NONE;
+    std::uint32_t visits = 0;
+    // the number of times the move was legal when its parent was visited
+    std::uint32_t availability = 0;
+    // the sums of the normalized scores and of the points backed up through
+    // the node
+    double score = 0;
+    double points = 0;
+
+    bool expanded() const { return first_child != NONE; }
+  };
+
+  static_assert(sizeof(Node) == 32);
+
+  /**
+     @param capacity, the number of nodes to allocate memory for up front
+   */
+  explicit NodeArena(std::size_t capacity = 0);
+
+  /**
+     Empty the pool, keeping its memory, and add the root, of index 0 and an
+     empty move.
+   */
+  void reset();
+
+  /**
+     Add a child of parent with move, first among its children.
+
+     @return the index of the child
+
+     @throw std::runtime_error if the pool would exceed NONE nodes.
+   */
+  Index add_child(Index parent, const CardSet& move);
+
+  /**
+     Allocate the children of parent, one per move, contiguously and in the
+     order of moves.
+
+     @return the index of the first child
+
+     @throw std::runtime_error if parent is already expanded or if the pool
+     would exceed NONE nodes.
+   */
+  Index expand(Index parent, const std::vector<CardSet>& moves);
+
+  Node& operator[](Index node) { return m_nodes[node]; }
+  const Node& operator[](Index node) const { return m_nodes[node]; }
+
+  const CardSet& move(Index node) const { return m_moves[node]; }
+
+  // @return the index of the child of parent with the move, or NONE
+  Index find_child(Index parent, const CardSet& move) const;
+
+  std::size_t size() const { return m_size; }
+
+  std::size_t capacity() const { return m_nodes.size(); }
+
+ private:
+  // grown but never shrunk, with the nodes past m_size unused
+  std::vector<Node> m_nodes;
+  std::vector<CardSet> m_moves;
+  std::size_t m_size = 0;
+
+  // @return the index of the first of n new nodes
+  Index allocate(std::size_t n);
+};
+}  // namespace rankup
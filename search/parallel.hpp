@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rankup {
+/**
+   @return num_threads if positive, or else the number of hardware threads
+ */
+inline int resolve_num_threads(int num_threads) {
+  if (num_threads > 0) return num_threads;
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+   Call f(task, thread) for every task in [0, num_tasks) on num_threads
+   threads, where thread in [0, num_threads) identifies the calling thread so
+   that f can reuse per-thread state. Tasks are handed out one at a time, so
+   tasks of uneven cost still balance.
+
+   The first exception thrown by f stops the handing out of tasks and is
+   rethrown once all threads have joined.
+ */
+template <typename F>
+void parallel_for(std::size_t num_tasks, int num_threads, F&& f) {
+  num_threads = std::min<std::size_t>(num_threads, num_tasks);
+  if (num_threads <= 1) {
+    for (std::size_t task = 0; task < num_tasks; ++task) f(task, 0);
+    return;
+  }
+
+  std::atomic<std::size_t> next{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto work = [&](int thread) {
+    try {
+      for (auto task = next++; task < num_tasks; task = next++)
+        f(task, thread);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) error = std::current_exception();
+      next = num_tasks;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 1; t < num_threads; ++t) threads.emplace_back(work, t);
+  work(0);
+  for (auto& thread : threads) thread.join();
+  if (error) std::rethrow_exception(error);
+}
+}  // namespace rankup
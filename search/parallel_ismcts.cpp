@@ -0,0 +1,271 @@
+#include "search/parallel_ismcts.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+#include "common/hash.hpp"
+#include "profile/stats.hpp"
+#include "profile/trace.hpp"
+#include "search/deal_sampler.hpp"
+#include "search/move_equivalence.hpp"
+#include "search/parallel.hpp"
+
+namespace rankup {
+namespace {
+// the points normalizing the scores into [0, 1]
+constexpr int MAX_POINTS = 200;
+
+// the number of iterations of thread t when splitting max_iterations
+int iterations_of(int max_iterations, int num_threads, int t) {
+  if (max_iterations <= 0) return 0;
+  return max_iterations / num_threads + (t < max_iterations % num_threads);
+}
+}  // namespace
+
+ParallelIsmcts::ParallelIsmcts(const Rules& rules,
+                               std::unique_ptr<RolloutPolicy> policy)
+    : m_rules(rules), m_generator(rules), m_policy(std::move(policy)) {
+  if (!m_policy) m_policy = std::make_unique<GreedyRollout>();
+  m_locks = std::make_unique<std::mutex[]>(NUM_LOCKS);
+}
+
+ParallelIsmcts::~ParallelIsmcts() = default;
+
+std::vector<Ismcts::MoveStats> ParallelIsmcts::search(
+    const CardTracker& tracker, const PlayState& state,
+    const Options& options) {
+  RANKUP_TRACE_SCOPE("ParallelIsmcts::search");
+  const int player = tracker.seat();
+  if (state.finished() or state.seat != player or
+      state.deal.hands[player] != tracker.hand()) {
+    RANKUP_STATS_COUNT(EXCEPTION);
+    throw std::runtime_error(
+        "ParallelIsmcts::search called with a position not of the player to "
+        "play!");
+  }
+
+  // the sampler is built once, outside the time budget, and shared by the
+  // threads
+  const bool kitty_hidden = state.deal.declarer != player;
+  const DealSampler sampler(tracker, kitty_hidden ? options.kitty_size : 0);
+  auto res = options.mode == Mode::ROOT ? search_roots(sampler, state, options)
+                                        : search_tree(sampler, state, options);
+  std::stable_sort(res.begin(), res.end(),
+                   [](const Ismcts::MoveStats& a, const Ismcts::MoveStats& b) {
+                     return a.visits > b.visits;
+                   });
+  return res;
+}
+
+std::vector<Ismcts::MoveStats> ParallelIsmcts::search_roots(
+    const DealSampler& sampler, const PlayState& state,
+    const Options& options) {
+  const int num_threads = resolve_num_threads(options.num_threads);
+  while (static_cast<int>(m_engines.size()) < num_threads)
+    m_engines.push_back(std::make_unique<Ismcts>(m_rules, m_policy->clone()));
+
+  std::vector<std::vector<Ismcts::MoveStats>> stats(num_threads);
+  parallel_for(num_threads, num_threads, [&](std::size_t t, int) {
+    auto own = static_cast<Ismcts::Options>(options);
+    own.max_iterations = iterations_of(options.max_iterations, num_threads, t);
+    own.seed = mix64(options.seed + t);
+    if (options.max_iterations > 0 and own.max_iterations == 0) return;
+    stats[t] = m_engines[t]->search(sampler, state, own);
+  });
+
+  // merge the root moves, weighting the mean points by the visits
+  std::vector<Ismcts::MoveStats> res;
+  m_num_iterations = 0;
+  for (int t = 0; t < num_threads; ++t) {
+    if (stats[t].empty()) continue;
+    m_num_iterations += m_engines[t]->num_iterations();
+    for (const auto& s : stats[t]) {
+      auto it = std::find_if(
+          res.begin(), res.end(),
+          [&s](const Ismcts::MoveStats& r) { return r.move == s.move; });
+      if (it == res.end()) {
+        res.push_back({s.move, 0, 0});
+        it = res.end() - 1;
+      }
+      it->mean_points += s.mean_points * s.visits;
+      it->visits += s.visits;
+    }
+  }
+  for (auto& r : res)
+    if (r.visits) r.mean_points /= r.visits;
+  return res;
+}
+
+std::vector<Ismcts::MoveStats> ParallelIsmcts::search_tree(
+    const DealSampler& sampler, const PlayState& state,
+    const Options& options) {
+  const auto deadline = std::chrono::steady_clock::now() + options.time_budget;
+  const int num_threads = resolve_num_threads(options.num_threads);
+  const int player = state.seat;
+  const bool kitty_hidden = sampler.num_bins() > NUM_SEATS;
+
+  // reset the tree, whose nodes are reinitialized as they are allocated
+  const auto capacity = std::max<std::size_t>(1, options.max_nodes);
+  if (capacity != m_capacity) {
+    m_nodes = std::make_unique<Node[]>(capacity);
+    m_capacity = capacity;
+  }
+  auto allocate = [this](const CardSet& move, bool attacker,
+                         int visits, std::int64_t score) {
+    const auto n = m_num_nodes++;
+    if (n >= m_capacity) return -1;
+    auto& node = m_nodes[n];
+    node.move = move;
+    node.attacker = attacker;
+    node.next_sibling = -1;
+    node.first_child.store(-1, std::memory_order_relaxed);
+    node.visits.store(visits, std::memory_order_relaxed);
+    node.availability.store(1, std::memory_order_relaxed);
+    node.score.store(score, std::memory_order_relaxed);
+    node.points.store(0, std::memory_order_relaxed);
+    return static_cast<int>(n);
+  };
+  m_num_nodes = 0;
+  allocate(CardSet(), false, 0, 0);
+
+  const int vl = std::max(0, options.virtual_loss);
+  std::atomic<std::uint64_t> next_iteration{0};
+  std::atomic<std::uint64_t> num_iterations{0};
+  std::atomic<bool> timed_out{false};
+  std::vector<std::unique_ptr<RolloutPolicy>> policies(num_threads);
+  for (auto& policy : policies) policy = m_policy->clone();
+
+  parallel_for(num_threads, num_threads, [&](std::size_t t, int) {
+    std::mt19937_64 gen(mix64(options.seed + t));
+    auto& policy = *policies[t];
+    std::vector<CardSet> bins;
+    std::vector<CardSet> moves;
+    std::vector<int> path;
+    MoveEquivalenceCache equivalences(m_rules);
+
+    while (!timed_out.load(std::memory_order_relaxed)) {
+      if (options.max_iterations > 0 and
+          next_iteration++ >=
+              static_cast<std::uint64_t>(options.max_iterations))
+        break;
+      // as in Ismcts, the first iteration runs whatever the time
+      if (num_iterations.load(std::memory_order_relaxed) > 0 and
+          std::chrono::steady_clock::now() > deadline) {
+        timed_out = true;
+        break;
+      }
+
+      // determinize
+      PlayState determinized(state);
+      sampler.sample(gen, bins);
+      for (int s = 0; s < NUM_SEATS; ++s)
+        if (s != player) determinized.deal.hands[s] = bins[s];
+      if (kitty_hidden) determinized.deal.kitty = bins[NUM_SEATS];
+
+      // select and expand, adding virtual losses along the way
+      path.assign(1, 0);
+      int node = 0;
+      while (!determinized.finished()) {
+        const auto& hand = determinized.deal.hands[determinized.seat];
+        moves.clear();
+        if (determinized.round)
+          m_generator.follows(*determinized.round, hand, moves);
+        else
+          m_generator.leads(hand, moves);
+        if (options.compress_moves)
+          equivalences.get(hand, determinized.out_of_play()).compress(moves);
+
+        const bool attacker = is_attacker(determinized.deal, determinized.seat);
+        const std::int64_t loss = attacker ? 0 : vl * MAX_POINTS;
+        int best = -1;
+        double best_value = -std::numeric_limits<double>::infinity();
+        int c = m_nodes[node].first_child.load(std::memory_order_acquire);
+        const int first_seen = c;
+        for (; c >= 0; c = m_nodes[c].next_sibling) {
+          auto it = std::find(moves.begin(), moves.end(), m_nodes[c].move);
+          if (it == moves.end()) continue;
+          *it = moves.back();
+          moves.pop_back();
+
+          auto& child = m_nodes[c];
+          const int availability = ++child.availability;
+          const int visits = child.visits.load(std::memory_order_relaxed);
+          double value = std::numeric_limits<double>::infinity();
+          if (visits > 0) {
+            const double mean =
+                child.score.load(std::memory_order_relaxed) /
+                (double(MAX_POINTS) * visits);
+            value = (attacker ? mean : 1 - mean) +
+                    options.exploration *
+                        std::sqrt(std::log(availability) / visits);
+          }
+          if (value > best_value) {
+            best = c;
+            best_value = value;
+          }
+        }
+
+        bool expanded = false;
+        if (!moves.empty() and m_num_nodes.load() < m_capacity) {
+          // expand an untried move, unless other threads tried them all
+          std::lock_guard<std::mutex> lock(m_locks[node % NUM_LOCKS]);
+          const int first = m_nodes[node].first_child.load();
+          for (int d = first; d != first_seen; d = m_nodes[d].next_sibling) {
+            auto it = std::find(moves.begin(), moves.end(), m_nodes[d].move);
+            if (it == moves.end()) continue;
+            *it = moves.back();
+            moves.pop_back();
+          }
+          if (!moves.empty()) {
+            const int child = allocate(moves[gen() % moves.size()], attacker,
+                                       vl, loss);
+            if (child >= 0) {
+              m_nodes[child].next_sibling = first;
+              m_nodes[node].first_child.store(child,
+                                              std::memory_order_release);
+              best = child;
+              expanded = true;
+            }
+          }
+        }
+        if (best < 0) break;  // the tree is full and no child is legal
+
+        if (!expanded) {
+          m_nodes[best].visits += vl;
+          m_nodes[best].score += loss;
+        }
+        node = best;
+        path.push_back(node);
+        determinized.play(m_rules, m_nodes[node].move);
+        if (expanded) break;
+      }
+
+      // simulate and back up, taking back the virtual losses
+      const int points = play_out(m_generator, determinized, policy, gen);
+      const int score = std::min(points, MAX_POINTS);
+      for (const auto n : path) {
+        auto& nd = m_nodes[n];
+        const int taken = n == 0 ? 0 : vl;
+        nd.visits += 1 - taken;
+        nd.score += score - (nd.attacker or n == 0 ? 0 : taken * MAX_POINTS);
+        nd.points += points;
+      }
+      ++num_iterations;
+    }
+  });
+  m_num_iterations = num_iterations;
+
+  std::vector<Ismcts::MoveStats> res;
+  for (int c = m_nodes[0].first_child; c >= 0; c = m_nodes[c].next_sibling) {
+    const auto& child = m_nodes[c];
+    const int visits = child.visits;
+    res.push_back({child.move, visits,
+                   visits ? double(child.points) / visits : 0});
+  }
+  return res;
+}
+}  // namespace rankup
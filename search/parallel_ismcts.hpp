@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/card_tracker.hpp"
+#include "search/deal_sampler.hpp"
+#include "search/ismcts.hpp"
+#include "search/moves.hpp"
+#include "search/play_state.hpp"
+#include "search/rollout.hpp"
+
+namespace rankup {
+/**
+   ISMCTS on several threads, in either of two ways chosen per search:
+
+   - ROOT: every thread searches a tree of its own with Ismcts, and the
+     statistics of the root moves are merged at the end. Threads never
+     synchronize, but the trees repeat each other's work.
+   - TREE: all threads search one shared tree whose statistics are atomic
+     counters. A thread descending through a node adds a virtual loss to it,
+     i.e. visits that count as lost for the seat making the move until the
+     result is backed up, which steers the other threads to other moves.
+     Only the expansion of a node takes a lock, striped over the nodes.
+ */
+class ParallelIsmcts {
+ public:
+  enum class Mode { ROOT, TREE };
+
+  struct Options : Ismcts::Options {
+    Mode mode = Mode::ROOT;
+    // the number of threads, or 0 for all hardware threads
+    int num_threads = 0;
+    // the number of visits lost by a node while a thread is below it
+    int virtual_loss = 1;
+    // the capacity of the shared tree, beyond which nodes are not expanded
+    std::size_t max_nodes = 1 << 18;
+  };
+
+  /**
+     @param policy, the rollout policy cloned for every thread, GreedyRollout
+     if nullptr
+   */
+  explicit ParallelIsmcts(const Rules& rules,
+                          std::unique_ptr<RolloutPolicy> policy = nullptr);
+
+  ~ParallelIsmcts();
+
+  /**
+     Same as Ismcts::search, with max_iterations counting the iterations of
+     all threads. The DealSampler is built once and shared by the threads.
+   */
+  std::vector<Ismcts::MoveStats> search(const CardTracker& tracker,
+                                        const PlayState& state,
+                                        const Options& options);
+
+  std::uint64_t num_iterations() const { return m_num_iterations; }
+
+ private:
+  struct Node {
+    CardSet move;
+    // whether the seat making the move attacks
+    bool attacker = false;
+    int next_sibling = -1;
+    std::atomic<int> first_child{-1};
+    std::atomic<int> visits{0};
+    std::atomic<int> availability{0};
+    // the sum of the points of the attackers, capped at 200 per visit, and
+    // the virtual losses
+    std::atomic<std::int64_t> score{0};
+    std::atomic<std::int64_t> points{0};
+  };
+
+  static constexpr int NUM_LOCKS = 256;
+
+  const Rules& m_rules;
+  MoveGenerator m_generator;
+  std::unique_ptr<RolloutPolicy> m_policy;
+  std::uint64_t m_num_iterations = 0;
+
+  // per thread, for ROOT
+  std::vector<std::unique_ptr<Ismcts>> m_engines;
+
+  // the shared tree, for TREE
+  std::unique_ptr<Node[]> m_nodes;
+  std::size_t m_capacity = 0;
+  std::atomic<std::size_t> m_num_nodes{0};
+  std::unique_ptr<std::mutex[]> m_locks;
+
+  std::vector<Ismcts::MoveStats> search_roots(const DealSampler& sampler,
+                                              const PlayState& state,
+                                              const Options& options);
+
+  std::vector<Ismcts::MoveStats> search_tree(const DealSampler& sampler,
+                                             const PlayState& state,
+                                             const Options& options);
+};
+}  // namespace rankup
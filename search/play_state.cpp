@@ -0,0 +1,62 @@
+#include "search/play_state.hpp"
+
+namespace rankup {
+namespace {
+// whether move may defeat the cards winning round, decided on the lorded
+// suits and strengths of the cards without parsing them: a move of several
+// lorded suits, or of a folk suit other than that of winning, never wins,
+// nor does a single no stronger than a single winning in its suit
+bool may_defeat(const Rules& rules, const RoundRules& round,
+                const CardSet& winning, const CardSet& move) {
+  const auto suit = rules.lorded_suit(Card::from_index(
+      __builtin_ctzll(move.once())));
+  for (auto m = move.once(); m; m &= m - 1)
+    if (rules.lorded_suit(Card::from_index(__builtin_ctzll(m))) != suit)
+      return false;
+  const auto winning_suit = round.winning_composition().suit();
+  if (suit != winning_suit) return suit == Suit::J;
+  if (move.size() > 1) return true;
+  return rules.strength(Card::from_index(__builtin_ctzll(move.once()))) >
+         rules.strength(Card::from_index(__builtin_ctzll(winning.once())));
+}
+}  // namespace
+
+void PlayState::play(const Rules& rules, const CardSet& move) {
+  if (!round) {
+    round.emplace(rules.start_round_with(move.to_vector()));
+    winner = seat;
+    winning_cards = move;
+  } else if (may_defeat(rules, *round, winning_cards, move) and
+             round->update_if_defeated_by(move.to_vector())) {
+    winner = seat;
+    winning_cards = move;
+  }
+  trick_points += move.points();
+  deal.hands[seat] -= move;
+
+  if (++num_played < NUM_SEATS) {
+    seat = (seat + 1) % NUM_SEATS;
+    return;
+  }
+  if (is_attacker(deal, winner)) {
+    points += trick_points;
+    if (deal.hands[winner].empty()) {
+      points += deal.kitty.points() *
+                kitty_multiplier(round->winning_composition());
+    }
+  }
+  round.reset();
+  winning_cards = CardSet();
+  seat = winner;
+  num_played = 0;
+  trick_points = 0;
+}
+
+CardSet PlayState::out_of_play() const {
+  CardSet res(ALL_CARD_BITS, ALL_CARD_BITS);
+  for (const auto& hand : deal.hands) res -= hand;
+  res -= deal.kitty;
+  res -= winning_cards;
+  return res;
+}
+}  // namespace rankup
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <optional>
+
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/double_dummy.hpp"
+
+namespace rankup {
+/**
+   A position of a deal being played with every hand known, e.g. a
+   determinization of the hands hidden from a player. Tricks are resolved by
+   Rules::start_round_with and RoundRules::update_if_defeated_by.
+ */
+struct PlayState {
+  Deal deal;
+  // the seat to play
+  int seat = 0;
+  // the current trick, nullopt before its lead
+  std::optional<RoundRules> round;
+  // the seat winning the current trick, and its cards
+  int winner = 0;
+  CardSet winning_cards;
+  // the number of plays of the current trick
+  int num_played = 0;
+  int trick_points = 0;
+  // the points the attackers collected from finished tricks, including the
+  // multiplied kitty once the last trick is won by them
+  int points = 0;
+
+  bool finished() const { return !round and deal.hands[seat].empty(); }
+
+  /**
+     @return the cards out of play, i.e. in neither a hand, the kitty nor the
+     cards winning the current trick
+   */
+  CardSet out_of_play() const;
+
+  /**
+     Play move, which must be legal, from the hand of seat. The trick ends
+     after NUM_SEATS plays, and its winner plays next.
+
+     Follows that can't win the trick, by their suits or as weaker singles,
+     are told apart on bitmasks without allocating; leads and the other
+     follows are parsed by Rules and RoundRules.
+   */
+  void play(const Rules& rules, const CardSet& move);
+};
+}  // namespace rankup
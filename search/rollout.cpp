@@ -0,0 +1,464 @@
+#include "search/rollout.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include "common/strength_mask.hpp"
+
+namespace rankup {
+namespace {
+// the cards of set, the cheapest first
+void cheapest_first(const Rules& rules, const CardSet& set, bool give_points,
+                    std::vector<Card>& cards) {
+  cards = set.to_vector();
+  std::sort(cards.begin(), cards.end(),
+            [&rules, give_points](const Card& a, const Card& b) {
+              const int pa = give_points ? -points_of(a) : points_of(a);
+              const int pb = give_points ? -points_of(b) : points_of(b);
+              if (pa != pb) return pa < pb;
+              return rules.strength(a) < rules.strength(b);
+            });
+}
+
+// the bitmasks over strength of the cards of set and of its pairs
+void strengths_of(const std::array<int8_t, NUM_CARD_KINDS>& strength,
+                  const CardSet& set, std::uint32_t& singles,
+                  std::uint32_t& pairs) {
+  singles = 0;
+  pairs = 0;
+  for (auto m = set.once(); m; m &= m - 1)
+    singles |= 1u << strength[__builtin_ctzll(m)];
+  for (auto m = set.twice(); m; m &= m - 1)
+    pairs |= 1u << strength[__builtin_ctzll(m)];
+}
+
+
+// the number of components of each axle that RoundRules::get_required_format
+// asks of a hand with the cards suited of the led suit of format. The hand
+// is parsed on the strengths of its cards the same way Rules parses cards:
+// pairs of adjacent strengths make tractors, and pairs of minor lords, which
+// have the same strength, beyond the first are pairs of their own. Then the
+// components are matched as in Format::extract_required_format_from.
+void required_axles(const Format& format,
+                    const std::array<int8_t, NUM_CARD_KINDS>& strength,
+                    const CardSet& suited,
+                    std::array<int8_t, NUM_STRENGTHS + 1>& res) {
+  // max-heaps of the axles of format and of the hand, each axle standing for
+  // at least one card
+  std::array<int8_t, 2 * NUM_CARD_KINDS> heap_a, heap_b;
+  int size_a = 0;
+  int size_b = 0;
+  auto push = [](std::array<int8_t, 2 * NUM_CARD_KINDS>& heap, int& size,
+                 int8_t axle) {
+    heap[size++] = axle;
+    std::push_heap(heap.begin(), heap.begin() + size);
+  };
+  auto pop = [](std::array<int8_t, 2 * NUM_CARD_KINDS>& heap, int& size) {
+    std::pop_heap(heap.begin(), heap.begin() + size);
+    return heap[--size];
+  };
+
+  for (int8_t axle = format.total_num_cards() / 2; axle >= 0; --axle)
+    for (int c = 0; c < format.get_count_at_or_0(axle); ++c)
+      push(heap_a, size_a, axle);
+
+  std::array<int8_t, NUM_STRENGTHS> pairs_at{};
+  for (auto m = suited.twice(); m; m &= m - 1)
+    ++pairs_at[strength[__builtin_ctzll(m)]];
+  std::uint32_t pairs = 0;
+  int num_pairs = 0;
+  for (int st = 0; st < NUM_STRENGTHS; ++st) {
+    if (!pairs_at[st]) continue;
+    pairs |= 1u << st;
+    num_pairs += pairs_at[st];
+    for (int i = 1; i < pairs_at[st]; ++i) push(heap_b, size_b, 1);
+  }
+  while (pairs) {
+    const int8_t start = __builtin_ctz(pairs);
+    push(heap_b, size_b, __builtin_ctz(~(pairs >> start)));
+    pairs &= pairs + (1u << start);
+  }
+  for (int i = suited.size() - 2 * num_pairs; i > 0; --i)
+    push(heap_b, size_b, 0);
+
+  res.fill(0);
+  while (size_a > 0 and size_b > 0) {
+    const auto ax_a = pop(heap_a, size_a);
+    const auto ax_b = pop(heap_b, size_b);
+    if (ax_a < ax_b) {
+      ++res[ax_a];
+      push(heap_b, size_b, ax_b - ax_a);
+    } else if (ax_b == 0) {
+      ++res[0];
+      for (int c = 1; c < 2 * ax_a; ++c) push(heap_a, size_a, 0);
+    } else {
+      ++res[ax_b];
+      if (ax_a > ax_b) push(heap_a, size_a, ax_a - ax_b);
+    }
+  }
+}
+
+// add the cards of from to move in order until move has num_cards cards
+void fill(const std::array<int8_t, NUM_CARD_KINDS>& order, const CardSet& from,
+          int num_cards, CardSet& move) {
+  for (const auto i : order) {
+    if (move.size() >= num_cards) return;
+    const auto card = Card::from_index(i);
+    for (int n = from.count(card) - move.count(card);
+         n > 0 and move.size() < num_cards; --n)
+      move.add(card);
+  }
+}
+}  // namespace
+
+CardSet RandomRollout::choose(const MoveGenerator& generator,
+                              const PlayState& state, std::mt19937_64& gen) {
+  const auto& hand = state.deal.hands[state.seat];
+  m_moves.clear();
+  if (state.round)
+    generator.follows(*state.round, hand, m_moves);
+  else
+    generator.leads(hand, m_moves);
+  return m_moves[gen() % m_moves.size()];
+}
+
+CardSet GreedyRollout::choose(const MoveGenerator& generator,
+                              const PlayState& state, std::mt19937_64&) {
+  const auto& rules = generator.rules();
+  const auto& hand = state.deal.hands[state.seat];
+  const bool partner_winning = (state.winner - state.seat) % 2 == 0;
+  m_moves.clear();
+  if (!state.round) {
+    generator.leads(hand, m_moves);
+    return choose_among(rules, state);
+  }
+
+  // singles are worth trying to win, larger follows just go cheaply
+  const auto& format = state.round->format();
+  const int num_cards = format.total_num_cards();
+  const auto suited = generator.cards_of(hand, *format.suit());
+  if (num_cards > 1) {
+    const auto required = suited.size() > num_cards
+                              ? state.round->get_required_format(
+                                    hand.to_vector())
+                              : Format();
+    CardSet move;
+    if (follow_cheaply(rules, hand, suited, required, num_cards,
+                       partner_winning, move))
+      return move;
+  }
+  generator.follows(*state.round, hand, m_moves);
+  return choose_among(rules, state);
+}
+
+CardSet GreedyRollout::choose_among(const Rules& rules,
+                                    const PlayState& state) const {
+  const bool partner_winning = (state.winner - state.seat) % 2 == 0;
+  CardSet best;
+  long best_score = 0;
+  bool first = true;
+  for (const auto& move : m_moves) {
+    const auto cards = move.to_vector();
+    int strength = 0;
+    int highest = 0;
+    for (const auto& card : cards) {
+      strength += rules.strength(card);
+      highest = std::max<int>(highest, rules.strength(card));
+    }
+    long score = 0;
+    if (!state.round) {
+      score = 32 * move.size() + highest;
+    } else if (partner_winning) {
+      score = 64 * move.points() - strength;
+    } else {
+      auto round = *state.round;
+      const bool beats = round.update_if_defeated_by(cards);
+      score = beats ? 1024 * 1024 - strength : -64 * move.points() - strength;
+    }
+    if (first or score > best_score) {
+      best = move;
+      best_score = score;
+      first = false;
+    }
+  }
+  return best;
+}
+
+/**
+   Build a follow of num_cards cards directly: all cards of the led suit
+   filled up with the cheapest others, or the weakest tractors and pairs of
+   the led suit that required asks for, then the cheapest cards of the suit.
+
+   @return false if required asks for a tractor the greedy choice misses
+ */
+bool GreedyRollout::follow_cheaply(const Rules& rules, const CardSet& hand,
+                                   const CardSet& suited,
+                                   const Format& required, int num_cards,
+                                   bool give_points, CardSet& move) {
+  move = CardSet();
+  if (suited.size() <= num_cards) {
+    move = suited;
+    auto others = hand;
+    others -= suited;
+    cheapest_first(rules, others, give_points, m_cards);
+    for (int i = 0; move.size() < num_cards; ++i) move.add(m_cards[i]);
+    return true;
+  }
+
+  // pairs of the suit, keyed by strength
+  std::array<std::uint64_t, NUM_STRENGTHS> pairs_at{};
+  for (auto m = suited.twice(); m; m &= m - 1) {
+    const auto card = Card::from_index(__builtin_ctzll(m));
+    pairs_at[rules.strength(card)] |= CardSet::bit(card);
+  }
+  for (int8_t axle = required.total_num_cards() / 2; axle >= 1; --axle) {
+    for (int n = 0; n < required.get_count_at_or_0(axle); ++n) {
+      int start = 0;
+      for (; start + axle <= 16; ++start) {
+        int length = 0;
+        while (length < axle and pairs_at[start + length]) ++length;
+        if (length == axle) break;
+      }
+      if (start + axle > 16) return false;
+      for (int i = 0; i < axle; ++i) {
+        const auto b = pairs_at[start + i] & -pairs_at[start + i];
+        pairs_at[start + i] &= ~b;
+        move += CardSet(b, b);
+      }
+    }
+  }
+
+  auto rest = suited;
+  rest -= move;
+  cheapest_first(rules, rest, give_points, m_cards);
+  for (int i = 0; move.size() < num_cards; ++i) move.add(m_cards[i]);
+  return true;
+}
+
+CardSet HeuristicRollout::choose(const MoveGenerator& generator,
+                                 const PlayState& state,
+                                 std::mt19937_64& gen) {
+  prepare(generator.rules());
+  return state.round ? follow(generator, state) : lead(generator, state, gen);
+}
+
+void HeuristicRollout::prepare(const Rules& rules) {
+  if (m_rules == &rules and m_lord_index == rules.lord_card().index()) return;
+  m_rules = &rules;
+  m_lord_index = rules.lord_card().index();
+  for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+    m_strength[i] = rules.strength(Card::from_index(i));
+    m_cheapest[i] = i;
+  }
+  m_richest = m_cheapest;
+  auto points = [](int8_t i) { return points_of(Card::from_index(i)); };
+  std::sort(m_cheapest.begin(), m_cheapest.end(), [&](int8_t a, int8_t b) {
+    if (points(a) != points(b)) return points(a) < points(b);
+    if (m_strength[a] != m_strength[b]) return m_strength[a] < m_strength[b];
+    return a < b;
+  });
+  std::sort(m_richest.begin(), m_richest.end(), [&](int8_t a, int8_t b) {
+    if (points(a) != points(b)) return points(a) > points(b);
+    if (m_strength[a] != m_strength[b]) return m_strength[a] < m_strength[b];
+    return a < b;
+  });
+}
+
+CardSet HeuristicRollout::lead(const MoveGenerator& generator,
+                               const PlayState& state,
+                               std::mt19937_64& gen) const {
+  const auto& hand = state.deal.hands[state.seat];
+  const CardSet* opponents[] = {
+      &state.deal.hands[(state.seat + 1) % NUM_SEATS],
+      &state.deal.hands[(state.seat + 3) % NUM_SEATS]};
+  std::uint32_t lord_singles[2], lord_pairs[2];
+  for (int o = 0; o < 2; ++o)
+    strengths_of(m_strength, generator.cards_of(*opponents[o], Suit::J),
+                 lord_singles[o], lord_pairs[o]);
+
+  CardSet best;
+  int best_rank = 0;
+  int num_plain_suits = 0;
+  for (int s = 0; s < NUM_LORDED_SUITS; ++s) {
+    const auto suit = static_cast<Suit>(s);
+    const auto own = generator.cards_of(hand, suit);
+    if (own.empty()) continue;
+    num_plain_suits += suit != Suit::J;
+
+    // the cards of each strength, and the strengths of the opponents
+    std::array<std::uint64_t, NUM_STRENGTHS> singles_at{};
+    std::array<std::uint64_t, NUM_STRENGTHS> pairs_at{};
+    for (auto m = own.once(); m; m &= m - 1)
+      singles_at[m_strength[__builtin_ctzll(m)]] |= m & -m;
+    for (auto m = own.twice(); m; m &= m - 1)
+      pairs_at[m_strength[__builtin_ctzll(m)]] |= m & -m;
+    std::uint32_t singles, pairs;
+    strengths_of(m_strength, own, singles, pairs);
+    std::uint32_t their_singles[2], their_pairs[2];
+    bool void_in[2];
+    for (int o = 0; o < 2; ++o) {
+      const auto theirs = generator.cards_of(*opponents[o], suit);
+      void_in[o] = theirs.empty() and suit != Suit::J;
+      strengths_of(m_strength, theirs, their_singles[o], their_pairs[o]);
+    }
+
+    // whether an opponent beats `length` pairs, or a single if 0, starting
+    // at strength start
+    auto beaten = [&](int length, int start) {
+      for (int o = 0; o < 2; ++o) {
+        if (void_in[o]) {
+          if (length == 0 ? lord_singles[o] != 0
+                          : runs_of(lord_pairs[o], length) != 0)
+            return true;
+        } else {
+          const auto mask = length == 0 ? their_singles[o]
+                                        : runs_of(their_pairs[o], length);
+          if (mask >> (start + 1)) return true;
+        }
+      }
+      return false;
+    };
+
+    // the largest unbeatable component, plain suits first
+    CardSet move;
+    for (int length = __builtin_popcount(pairs); length >= 1; --length) {
+      const auto runs = runs_of(pairs, length);
+      if (!runs) continue;
+      const int start = highest_bit(runs);
+      if (beaten(length, start)) continue;
+      for (int i = 0; i < length; ++i) {
+        const auto b = pairs_at[start + i] & -pairs_at[start + i];
+        move += CardSet(b, b);
+      }
+      break;
+    }
+    if (move.empty() and !beaten(0, highest_bit(singles))) {
+      const auto cards = singles_at[highest_bit(singles)];
+      move = CardSet(cards & -cards, 0);
+    }
+    const int rank = 2 * move.size() + (suit != Suit::J);
+    if (!move.empty() and rank > best_rank) {
+      best = move;
+      best_rank = rank;
+    }
+  }
+  if (!best.empty()) return best;
+
+  // the cheapest card of a plain suit drawn at random
+  std::uint64_t mask = 0;
+  if (num_plain_suits > 0) {
+    int n = gen() % num_plain_suits;
+    for (int s = 0; s < NUM_LORDED_SUITS; ++s) {
+      const auto suit = static_cast<Suit>(s);
+      if (suit == Suit::J or generator.cards_of(hand, suit).empty()) continue;
+      if (n-- == 0) {
+        mask = generator.mask(suit);
+        break;
+      }
+    }
+  } else {
+    mask = generator.mask(Suit::J);
+  }
+  CardSet move;
+  fill(m_cheapest, CardSet(hand.once() & mask, hand.twice() & mask), 1, move);
+  return move;
+}
+
+CardSet HeuristicRollout::follow(const MoveGenerator& generator,
+                                 const PlayState& state) {
+  const auto& hand = state.deal.hands[state.seat];
+  const auto& format = state.round->format();
+  const int num_cards = format.total_num_cards();
+  const auto suited = generator.cards_of(hand, *format.suit());
+  const bool partner_winning = (state.winner - state.seat) % 2 == 0;
+  const auto& order = partner_winning ? m_richest : m_cheapest;
+  CardSet move;
+
+  if (num_cards == 1) {
+    // out of the suit, keep the lords unless trumping
+    auto pool = suited;
+    if (pool.empty()) {
+      pool = hand;
+      const auto lords = generator.cards_of(hand, Suit::J);
+      if (lords.size() < hand.size()) pool -= lords;
+    }
+    if (!partner_winning and (!suited.empty() or state.trick_points > 0)) {
+      const int8_t winning = __builtin_ctzll(state.winning_cards.once());
+      const auto candidates = suited.empty() ? hand : suited;
+      for (const auto i : m_cheapest) {
+        if (candidates.contains(Card::from_index(i)) and
+            beats(generator, i, winning)) {
+          move.add(Card::from_index(i));
+          return move;
+        }
+      }
+    }
+    fill(order, pool, 1, move);
+    return move;
+  }
+
+  if (suited.size() <= num_cards) {
+    move = suited;
+    auto others = hand;
+    others -= suited;
+    fill(order, others, num_cards, move);
+    return move;
+  }
+
+  // the weakest pairs and tractors of the required format
+  std::array<int8_t, NUM_STRENGTHS + 1> required;
+  required_axles(format, m_strength, suited, required);
+  std::array<std::uint64_t, NUM_STRENGTHS> pairs_at{};
+  for (auto m = suited.twice(); m; m &= m - 1)
+    pairs_at[m_strength[__builtin_ctzll(m)]] |= m & -m;
+  for (int8_t axle = NUM_STRENGTHS; axle >= 1; --axle) {
+    for (int n = 0; n < required[axle]; ++n) {
+      int start = 0;
+      for (; start + axle <= NUM_STRENGTHS; ++start) {
+        int length = 0;
+        while (length < axle and pairs_at[start + length]) ++length;
+        if (length == axle) break;
+      }
+      if (start + axle > NUM_STRENGTHS) {
+        // the greedy choice misses a tractor, so fall back on the moves
+        m_moves.clear();
+        generator.follows(*state.round, hand, m_moves);
+        move = m_moves.front();
+        for (const auto& m : m_moves)
+          if (partner_winning ? m.points() > move.points()
+                              : m.points() < move.points())
+            move = m;
+        return move;
+      }
+      for (int i = 0; i < axle; ++i) {
+        const auto b = pairs_at[start + i] & -pairs_at[start + i];
+        pairs_at[start + i] &= ~b;
+        move += CardSet(b, b);
+      }
+    }
+  }
+  fill(order, suited, num_cards, move);
+  return move;
+}
+
+bool HeuristicRollout::beats(const MoveGenerator& generator, int8_t card,
+                             int8_t winning) const {
+  const auto bit = std::uint64_t(1) << card;
+  const auto winning_bit = std::uint64_t(1) << winning;
+  for (int s = 0; s < NUM_LORDED_SUITS; ++s) {
+    const auto mask = generator.mask(static_cast<Suit>(s));
+    if (!(mask & bit)) continue;
+    if (mask & winning_bit) return m_strength[card] > m_strength[winning];
+    return static_cast<Suit>(s) == Suit::J;
+  }
+  return false;
+}
+
+int play_out(const MoveGenerator& generator, PlayState& state,
+             RolloutPolicy& policy, std::mt19937_64& gen) {
+  const auto& rules = generator.rules();
+  while (!state.finished())
+    state.play(rules, policy.choose(generator, state, gen));
+  return state.points;
+}
+}  // namespace rankup
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "common/card_set.hpp"
+#include "search/moves.hpp"
+#include "search/play_state.hpp"
+
+namespace rankup {
+/**
+   A policy playing out positions, e.g. for the simulations of Monte Carlo
+   search. A policy may keep buffers, so each thread uses its own clone.
+ */
+class RolloutPolicy {
+ public:
+  virtual ~RolloutPolicy() = default;
+
+  /**
+     @return a legal move of state.seat, which must have cards left
+   */
+  virtual CardSet choose(const MoveGenerator& generator,
+                         const PlayState& state, std::mt19937_64& gen) = 0;
+
+  virtual std::unique_ptr<RolloutPolicy> clone() const = 0;
+};
+
+/**
+   Plays uniformly at random among the moves of MoveGenerator.
+ */
+class RandomRollout : public RolloutPolicy {
+ public:
+  CardSet choose(const MoveGenerator& generator, const PlayState& state,
+                 std::mt19937_64& gen) override;
+
+  std::unique_ptr<RolloutPolicy> clone() const override {
+    return std::make_unique<RandomRollout>();
+  }
+
+ private:
+  std::vector<CardSet> m_moves;
+};
+
+/**
+   Plays greedily: leads the largest and strongest component, takes a single
+   as cheaply as possible when an opponent is winning it, and otherwise gives
+   the most points to the partner or the fewest to the opponents. Follows of
+   several cards are built directly from the required format instead of
+   enumerating subsets.
+ */
+class GreedyRollout : public RolloutPolicy {
+ public:
+  CardSet choose(const MoveGenerator& generator, const PlayState& state,
+                 std::mt19937_64& gen) override;
+
+  std::unique_ptr<RolloutPolicy> clone() const override {
+    return std::make_unique<GreedyRollout>();
+  }
+
+ private:
+  std::vector<CardSet> m_moves;
+  std::vector<Card> m_cards;
+
+  CardSet choose_among(const Rules& rules, const PlayState& state) const;
+
+  bool follow_cheaply(const Rules& rules, const CardSet& hand,
+                      const CardSet& suited, const Format& required,
+                      int num_cards, bool give_points, CardSet& move);
+};
+
+/**
+   Plays by simple rules of thumb on bitmasks, without generating moves:
+
+   - leads the largest component, plain suits first, that no opponent can
+     beat with the cards of its hand, either in the suit or by trumping when
+     void, or else the cheapest card of a plain suit drawn with gen;
+   - follows a single by giving the most points to a partner winning the
+     trick, or by taking it with the cheapest card that does, trumping only
+     for points;
+   - follows several cards with the weakest pairs and tractors
+     RoundRules::get_required_format would ask for, counted on the strengths
+     of the cards, filled up with the cheapest cards, or the ones with the
+     most points for a partner winning the trick.
+
+   Moves depend on nothing but state and gen, and are chosen without heap
+   allocation once the buffers of the policy have grown, except for the
+   rare follows whose tractors the greedy choice misses, which fall back on
+   MoveGenerator::follows. Playing them with PlayState::play still
+   allocates when a trick starts, and for follows that may win it, which
+   RoundRules parses.
+ */
+class HeuristicRollout : public RolloutPolicy {
+ public:
+  CardSet choose(const MoveGenerator& generator, const PlayState& state,
+                 std::mt19937_64& gen) override;
+
+  std::unique_ptr<RolloutPolicy> clone() const override {
+    return std::make_unique<HeuristicRollout>();
+  }
+
+ private:
+  using Order = std::array<int8_t, NUM_CARD_KINDS>;
+
+  // the rules the tables below were made for
+  const Rules* m_rules = nullptr;
+  int8_t m_lord_index = -1;
+  std::array<int8_t, NUM_CARD_KINDS> m_strength{};
+  // Card::index() of the cards, the fewest points first, and the most
+  // points first, the weakest first among equal points
+  Order m_cheapest{};
+  Order m_richest{};
+
+  std::vector<CardSet> m_moves;
+
+  void prepare(const Rules& rules);
+
+  CardSet lead(const MoveGenerator& generator, const PlayState& state,
+               std::mt19937_64& gen) const;
+
+  CardSet follow(const MoveGenerator& generator, const PlayState& state);
+
+  // @return whether card defeats the single card winning
+  bool beats(const MoveGenerator& generator, int8_t card,
+             int8_t winning) const;
+};
+
+/**
+   Play state out to its end with policy.
+
+   @return the points the attackers collect in the whole deal
+ */
+int play_out(const MoveGenerator& generator, PlayState& state,
+             RolloutPolicy& policy, std::mt19937_64& gen);
+}  // namespace rankup
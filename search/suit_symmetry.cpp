@@ -0,0 +1,104 @@
+#include "search/suit_symmetry.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace rankup {
+namespace {
+constexpr int NUM_FOLK_SUITS = 4;
+constexpr std::uint64_t RANKS_OF_SUIT = (std::uint64_t(1) << 13) - 1;
+
+std::uint64_t ranks_of(std::uint64_t mask, int suit) {
+  return (mask >> (13 * suit)) & RANKS_OF_SUIT;
+}
+
+/**
+   Same as canonical_suits, with the folk suit `first`, if any, put before
+   the others.
+ */
+SuitPermutation sort_suits(const Card& lord_card, const CardSet* sets,
+                           int num_sets, std::optional<Suit> first) {
+  std::array<int, NUM_FOLK_SUITS> suits{};
+  int num_suits = 0;
+  for (int s = 0; s < NUM_FOLK_SUITS; ++s)
+    if (static_cast<Suit>(s) != lord_card.suit()) suits[num_suits++] = s;
+
+  // whether suit a comes before suit b
+  auto before = [&](int a, int b) {
+    if (first and (a == static_cast<int>(*first)) !=
+                      (b == static_cast<int>(*first)))
+      return a == static_cast<int>(*first);
+    for (int i = 0; i < num_sets; ++i) {
+      const auto once_a = ranks_of(sets[i].once(), a);
+      const auto once_b = ranks_of(sets[i].once(), b);
+      if (once_a != once_b) return once_a > once_b;
+      const auto twice_a = ranks_of(sets[i].twice(), a);
+      const auto twice_b = ranks_of(sets[i].twice(), b);
+      if (twice_a != twice_b) return twice_a > twice_b;
+    }
+    return false;
+  };
+  // insertion sort of the at most 4 suits
+  auto sorted = suits;
+  for (int i = 1; i < num_suits; ++i) {
+    const int suit = sorted[i];
+    int j = i;
+    for (; j > 0 and before(suit, sorted[j - 1]); --j)
+      sorted[j] = sorted[j - 1];
+    sorted[j] = suit;
+  }
+
+  // the i-th suit in canonical order takes the slot of the i-th folk suit
+  SuitPermutation res;
+  for (int i = 0; i < num_suits; ++i)
+    res.to[sorted[i]] = static_cast<Suit>(suits[i]);
+  return res;
+}
+}  // namespace
+
+CardSet SuitPermutation::operator()(const CardSet& cards) const {
+  constexpr auto FOLK = (std::uint64_t(1) << (13 * NUM_FOLK_SUITS)) - 1;
+  auto once = cards.once() & ~FOLK;
+  auto twice = cards.twice() & ~FOLK;
+  for (int s = 0; s < NUM_FOLK_SUITS; ++s) {
+    const int t = static_cast<int>(to[s]);
+    once |= ranks_of(cards.once(), s) << (13 * t);
+    twice |= ranks_of(cards.twice(), s) << (13 * t);
+  }
+  return CardSet(once, twice);
+}
+
+SuitPermutation SuitPermutation::inverse() const {
+  SuitPermutation res;
+  for (int s = 0; s < NUM_LORDED_SUITS; ++s)
+    res.to[static_cast<int>(to[s])] = static_cast<Suit>(s);
+  return res;
+}
+
+SuitPermutation canonical_suits(const Card& lord_card, const CardSet* sets,
+                                int num_sets) {
+  return sort_suits(lord_card, sets, num_sets, std::nullopt);
+}
+
+SuitPermutation canonicalize(PlayState& state, CardSet& played) {
+  constexpr int NUM_SETS = NUM_SEATS + 3;
+  CardSet sets[NUM_SETS];
+  for (int i = 0; i < NUM_SEATS; ++i) sets[i] = state.deal.hands[i];
+  sets[NUM_SEATS] = state.deal.kitty;
+  sets[NUM_SEATS + 1] = played;
+  sets[NUM_SEATS + 2] = state.winning_cards;
+
+  std::optional<Suit> led;
+  if (state.round) led = state.round->format().suit();
+  const auto res = sort_suits(state.deal.lord_card, sets, NUM_SETS, led);
+  if (res.is_identity()) return res;
+
+  for (auto& hand : state.deal.hands) hand = res(hand);
+  state.deal.kitty = res(state.deal.kitty);
+  state.winning_cards = res(state.winning_cards);
+  played = res(played);
+  if (state.round) state.round.emplace(state.round->relabeled(res.to));
+  return res;
+}
+}  // namespace rankup
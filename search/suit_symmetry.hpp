@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "search/play_state.hpp"
+
+namespace rankup {
+/**
+   A relabeling of the suits, taking each suit s to to[s]. Only folk suits
+   other than the suit of the lord card are ever relabeled, as they are the
+   ones interchangeable under Rules: their cards have the same values, and
+   their minor lords the same strength.
+ */
+struct SuitPermutation {
+  std::array<Suit, NUM_LORDED_SUITS> to = {Suit::D, Suit::C, Suit::H, Suit::S,
+                                           Suit::J};
+
+  Card operator()(const Card& card) const {
+    return Card(to[static_cast<int>(card.suit())], card.rank());
+  }
+
+  CardSet operator()(const CardSet& cards) const;
+
+  SuitPermutation inverse() const;
+
+  bool is_identity() const { return *this == SuitPermutation(); }
+
+  bool operator==(const SuitPermutation& other) const {
+    return to == other.to;
+  }
+};
+
+/**
+   @param sets, the sets of cards to canonicalize together, e.g. the hands
+   seat by seat followed by the played cards
+
+   @return the permutation putting the folk suits other than the suit of
+   lord_card in canonical order, i.e. their cards in sets, compared set by
+   set and once() before twice(), in descending order over the suits in the
+   order of Suit. Sets that are relabeled versions of each other have the same
+   canonical form.
+ */
+SuitPermutation canonical_suits(const Card& lord_card, const CardSet* sets,
+                                int num_sets);
+
+/**
+   Relabel the folk suits of state and played into their canonical order,
+   which is that of canonical_suits over the hands seat by seat, the kitty,
+   played and the cards winning the current trick, after putting first the
+   suit led to the current trick. The round is relabeled with
+   RoundRules::relabeled.
+
+   @return the permutation applied, whose inverse takes moves of the
+   canonical state back to the original one
+ */
+SuitPermutation canonicalize(PlayState& state, CardSet& played);
+}  // namespace rankup
@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "search/batch_solver.hpp"
+#include "search/double_dummy.hpp"
+#include "search/tests/test_helpers.hpp"
+
+using namespace rankup;
+
+namespace {
+std::vector<Deal> random_deals(int num_deals, int hand_size) {
+  std::mt19937_64 gen(37);
+  auto deck = test::double_deck();
+  const Card lords[] = {{Suit::S, Rank::_8}, {Suit::D, Rank::_2},
+                        {Suit::J, Rank::_5}, {Suit::J, Rank::_w}};
+
+  std::vector<Deal> deals(num_deals);
+  for (int n = 0; n < num_deals; ++n) {
+    std::shuffle(deck.begin(), deck.end(), gen);
+    auto& deal = deals[n];
+    deal.lord_card = lords[n % 4];
+    deal.declarer = n % NUM_SEATS;
+    test::deal_from(deck, hand_size, 8, deal);
+  }
+  return deals;
+}
+}  // namespace
+
+SCENARIO("BatchSolver", "[search]") {
+  const auto deals = random_deals(40, 3);
+  DoubleDummySolver reference(1 << 20);
+  BatchSolver batch(4, 1 << 20);
+  REQUIRE(batch.num_threads() == 4);
+
+  SECTION("declarers leading") {
+    std::vector<int> results;
+    batch.solve(deals, results);
+    REQUIRE(results.size() == deals.size());
+    for (std::size_t d = 0; d < deals.size(); ++d)
+      CHECK(results[d] == reference.solve(deals[d], deals[d].declarer));
+
+    THEN("solvers are reused by later calls") {
+      std::vector<int> again;
+      batch.solve(deals, again);
+      CHECK(again == results);
+    }
+  }
+
+  SECTION("every leader") {
+    std::vector<int> results;
+    batch.solve_all_leaders(deals, results);
+    REQUIRE(results.size() == NUM_SEATS * deals.size());
+    for (std::size_t d = 0; d < deals.size(); ++d) {
+      for (int leader = 0; leader < NUM_SEATS; ++leader) {
+        CHECK(results[NUM_SEATS * d + leader] ==
+              reference.solve(deals[d], leader));
+      }
+    }
+  }
+
+  SECTION("invalid deals are reported") {
+    auto invalid = deals;
+    invalid[17].hands[2] = CardSet();
+    std::vector<int> results;
+    CHECK_THROWS_AS(batch.solve(invalid, results), std::runtime_error);
+  }
+}
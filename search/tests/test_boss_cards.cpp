@@ -0,0 +1,85 @@
+#include <catch2/catch.hpp>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/boss_cards.hpp"
+
+using namespace rankup;
+
+SCENARIO("boss cards", "[search]") {
+  const Rules rules(Card(Suit::S, Rank::_2));
+  auto strength = [&rules](Suit suit, Rank rank) {
+    return rules.strength(Card(suit, rank));
+  };
+  auto lead = [&rules](std::vector<Card> cards) {
+    return rules.start_round_with(cards).winning_composition();
+  };
+
+  GIVEN("no card out") {
+    const BossCards bosses(rules);
+    const auto hearts = bosses.boss(Suit::H);
+    CHECK(hearts.single == strength(Suit::H, Rank::_A));
+    CHECK(hearts.pair == strength(Suit::H, Rank::_A));
+    CHECK(hearts.tractor == strength(Suit::H, Rank::_K));
+    CHECK(bosses.highest_tractor(Suit::H, 3) == strength(Suit::H, Rank::_Q));
+    CHECK(bosses.boss(Suit::J).single == strength(Suit::J, Rank::_W));
+
+    THEN("only the big joker is sure to win") {
+      CHECK(bosses.wins_as_lead(lead({{Suit::J, Rank::_W}})));
+      CHECK_FALSE(bosses.wins_as_lead(lead({{Suit::J, Rank::_w}})));
+      // an ace may be trumped
+      CHECK_FALSE(bosses.wins_as_lead(lead({{Suit::H, Rank::_A}})));
+      CHECK(bosses.wins_as_lead(lead({{Suit::H, Rank::_A}}), false));
+    }
+  }
+
+  GIVEN("an ace of hearts and both big jokers out") {
+    const BossCards bosses(rules, CardSet(std::vector<Card>{
+                                      {Suit::H, Rank::_A},
+                                      {Suit::J, Rank::_W},
+                                      {Suit::J, Rank::_W}}));
+    const auto hearts = bosses.boss(Suit::H);
+    CHECK(hearts.single == strength(Suit::H, Rank::_A));
+    CHECK(hearts.pair == strength(Suit::H, Rank::_K));
+    CHECK(hearts.tractor == strength(Suit::H, Rank::_Q));
+
+    THEN("a pair of kings and the small joker are bosses") {
+      CHECK(bosses.wins_as_lead(
+          lead({{Suit::H, Rank::_K}, {Suit::H, Rank::_K}}), false));
+      CHECK_FALSE(bosses.wins_as_lead(
+          lead({{Suit::H, Rank::_Q}, {Suit::H, Rank::_Q}}), false));
+      CHECK(bosses.wins_as_lead(lead({{Suit::J, Rank::_w}})));
+      CHECK(bosses.wins_as_lead(lead({{Suit::H, Rank::_K},
+                                      {Suit::H, Rank::_K},
+                                      {Suit::H, Rank::_Q},
+                                      {Suit::H, Rank::_Q}}),
+                                false));
+    }
+  }
+
+  GIVEN("every lord out") {
+    CardSet out;
+    for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+      const auto card = Card::from_index(i);
+      if (rules.lorded_suit(card) != Suit::J) continue;
+      out.add(card);
+      out.add(card);
+    }
+    BossCards bosses(rules, out);
+    CHECK(bosses.boss(Suit::J).single == -1);
+    THEN("an ace can't be trumped") {
+      CHECK(bosses.wins_as_lead(lead({{Suit::H, Rank::_A}})));
+      CHECK_FALSE(bosses.wins_as_lead(lead({{Suit::H, Rank::_K}})));
+    }
+
+    WHEN("the aces are out too") {
+      out.add({Suit::H, Rank::_A});
+      out.add({Suit::H, Rank::_A});
+      bosses.update(out);
+      CHECK(bosses.wins_as_lead(lead({{Suit::H, Rank::_K}})));
+      CHECK(bosses.boss(Suit::H).single == strength(Suit::H, Rank::_K));
+    }
+  }
+}
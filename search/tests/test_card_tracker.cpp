@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/card_tracker.hpp"
+#include "search/moves.hpp"
+#include "search/tests/test_helpers.hpp"
+
+using namespace rankup;
+
+namespace {
+CardSet cards_of(const std::vector<Card>& cards) { return CardSet(cards); }
+}  // namespace
+
+SCENARIO("Card tracker", "[search]") {
+  const Rules rules(Card(Suit::S, Rank::_2));
+  const auto hand = cards_of({{Suit::H, Rank::_A},
+                              {Suit::H, Rank::_A},
+                              {Suit::H, Rank::_3},
+                              {Suit::C, Rank::_4}});
+  const auto kitty = cards_of({{Suit::D, Rank::_5}});
+  CardTracker tracker(rules, 0, hand, kitty);
+
+  REQUIRE(tracker.unseen().size() == 2 * NUM_CARD_KINDS - 5);
+  REQUIRE(tracker.possible(0) == hand);
+  REQUIRE(tracker.possible(1) == tracker.unseen());
+  REQUIRE_FALSE(tracker.next_seat());
+
+  WHEN("a seat follows a pair with singles of the suit") {
+    tracker.play(0, cards_of({{Suit::H, Rank::_A}, {Suit::H, Rank::_A}}));
+    REQUIRE(tracker.next_seat() == 1);
+    tracker.play(1, cards_of({{Suit::H, Rank::_4}, {Suit::H, Rank::_6}}));
+    THEN("it has no pair of hearts left, but is not void") {
+      CHECK(tracker.has_no_pair(1, Suit::H));
+      CHECK_FALSE(tracker.is_void(1, Suit::H));
+      const auto possible = tracker.possible(1);
+      CHECK(possible.count({Suit::H, Rank::_K}) == 1);
+      CHECK(possible.count({Suit::C, Rank::_K}) == 2);
+      // lord-rank hearts are lords
+      CHECK(possible.count({Suit::H, Rank::_2}) == 2);
+    }
+
+    AND_WHEN("a seat follows with another suit") {
+      tracker.play(2, cards_of({{Suit::H, Rank::_9}, {Suit::D, Rank::_9}}));
+      THEN("it is void in hearts") {
+        CHECK(tracker.is_void(2, Suit::H));
+        CHECK(tracker.possible(2).count({Suit::H, Rank::_K}) == 0);
+        CHECK(tracker.possible(3).count({Suit::H, Rank::_K}) == 2);
+      }
+      tracker.play(3, cards_of({{Suit::H, Rank::_Q}, {Suit::H, Rank::_Q}}));
+      CHECK_FALSE(tracker.has_no_pair(3, Suit::H));
+      CHECK_FALSE(tracker.next_seat());
+      CHECK(tracker.num_cards(0) == 2);
+      CHECK(tracker.num_cards(1) == 2);
+      CHECK(tracker.played().size() == 8);
+      CHECK(tracker.unseen().size() == 2 * NUM_CARD_KINDS - 11);
+    }
+  }
+
+  WHEN("a seat plays out of turn") {
+    tracker.play(0, cards_of({{Suit::H, Rank::_3}}));
+    REQUIRE_THROWS_AS(tracker.play(2, cards_of({{Suit::H, Rank::_4}})),
+                      std::runtime_error);
+  }
+
+  WHEN("the player plays cards not in hand") {
+    REQUIRE_THROWS_AS(tracker.play(0, cards_of({{Suit::H, Rank::_4}})),
+                      std::runtime_error);
+  }
+}
+
+SCENARIO("Card tracker is sound over whole games", "[search]") {
+  std::mt19937_64 gen(41);
+  for (const auto& lord :
+       {Card(Suit::S, Rank::_2), Card(Suit::H, Rank::_A),
+        Card(Suit::J, Rank::_7)}) {
+    const Rules rules(lord);
+    const MoveGenerator generator(rules);
+    for (int game = 0; game < 10; ++game) {
+      auto hands = test::hands_from(test::shuffled_deck(gen), 8);
+      CardTracker tracker(rules, 0, hands[0]);
+
+      int leader = 0;
+      std::vector<CardSet> moves;
+      while (!hands[leader].empty()) {
+        std::optional<RoundRules> round;
+        int winner = leader;
+        for (int i = 0; i < NUM_SEATS; ++i) {
+          const int seat = (leader + i) % NUM_SEATS;
+          moves.clear();
+          if (round)
+            generator.follows(*round, hands[seat], moves);
+          else
+            generator.leads(hands[seat], moves);
+          const auto move = moves[gen() % moves.size()];
+          if (round) {
+            if (round->update_if_defeated_by(move.to_vector())) winner = seat;
+          } else {
+            round.emplace(rules.start_round_with(move.to_vector()));
+          }
+          hands[seat] -= move;
+          tracker.play(seat, move);
+
+          // every actual hand is possible
+          for (int s = 0; s < NUM_SEATS; ++s) {
+            REQUIRE(hands[s].is_subset_of(tracker.possible(s)));
+            REQUIRE(tracker.num_cards(s) == hands[s].size());
+          }
+        }
+        leader = winner;
+      }
+      CHECK(tracker.played().size() == 32);
+    }
+  }
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/card_tracker.hpp"
+#include "search/deal_sampler.hpp"
+#include "search/tests/test_helpers.hpp"
+
+using namespace rankup;
+
+namespace {
+using Key = std::vector<std::pair<std::uint64_t, std::uint64_t>>;
+
+Key key_of(const std::vector<CardSet>& bins) {
+  Key res;
+  for (const auto& bin : bins) res.emplace_back(bin.once(), bin.twice());
+  return res;
+}
+
+// every deal of cards into bins satisfying the constraints
+void enumerate(const CardSet& cards, const std::vector<CardSet>& allowed,
+               const std::vector<int>& counts, std::vector<CardSet>& bins,
+               std::map<Key, int>& deals) {
+  const int b = bins.size();
+  if (b == static_cast<int>(counts.size())) {
+    deals[key_of(bins)] = 0;
+    return;
+  }
+  for_each_subset(cards, counts[b], [&](const CardSet& bin) {
+    if (!bin.is_subset_of(allowed[b])) return;
+    auto rest = cards;
+    rest -= bin;
+    bins.push_back(bin);
+    enumerate(rest, allowed, counts, bins, deals);
+    bins.pop_back();
+  });
+}
+}  // namespace
+
+SCENARIO("Deal sampler", "[search]") {
+  std::mt19937_64 gen(42);
+
+  SECTION("deals are uniform") {
+    const CardSet cards(std::vector<Card>{{Suit::H, Rank::_A},
+                                          {Suit::H, Rank::_A},
+                                          {Suit::H, Rank::_K},
+                                          {Suit::S, Rank::_3},
+                                          {Suit::S, Rank::_3},
+                                          {Suit::S, Rank::_4},
+                                          {Suit::D, Rank::_7},
+                                          {Suit::J, Rank::_W}});
+    // bin 1 is void in hearts, bin 2 has no pair left in spades
+    const std::vector<CardSet> allowed = {
+        cards,
+        CardSet(std::vector<Card>{{Suit::S, Rank::_3},
+                                  {Suit::S, Rank::_3},
+                                  {Suit::S, Rank::_4},
+                                  {Suit::D, Rank::_7},
+                                  {Suit::J, Rank::_W}}),
+        CardSet(std::vector<Card>{{Suit::H, Rank::_A},
+                                  {Suit::H, Rank::_A},
+                                  {Suit::H, Rank::_K},
+                                  {Suit::S, Rank::_3},
+                                  {Suit::S, Rank::_4},
+                                  {Suit::D, Rank::_7},
+                                  {Suit::J, Rank::_W}})};
+    const std::vector<int> counts = {3, 3, 2};
+
+    std::map<Key, int> deals;
+    std::vector<CardSet> bins;
+    enumerate(cards, allowed, counts, bins, deals);
+    REQUIRE(deals.size() > 5);
+
+    const DealSampler sampler(cards, allowed, counts);
+    CHECK(sampler.num_deals() == deals.size());
+    CHECK(sampler.num_bins() == 3);
+
+    const int num_samples = 2000 * deals.size();
+    for (int n = 0; n < num_samples; ++n) {
+      sampler.sample(gen, bins);
+      auto it = deals.find(key_of(bins));
+      REQUIRE(it != deals.end());
+      ++it->second;
+    }
+    for (const auto& [key, num] : deals) {
+      CHECK(num > 1700);
+      CHECK(num < 2300);
+    }
+  }
+
+  SECTION("deals from a tracker satisfy what it has seen") {
+    const Rules rules(Card(Suit::S, Rank::_2));
+    const auto hand = test::cards_from(test::shuffled_deck(gen), 0, 25);
+    CardTracker tracker(rules, 1, hand);
+
+    // seat 2 can't follow a heart led by seat 0
+    const auto unseen = tracker.unseen().to_vector();
+    auto unseen_of = [&](Suit suit) {
+      return CardSet(std::vector<Card>{*std::find_if(
+          unseen.begin(), unseen.end(), [&](const Card& card) {
+            return rules.lorded_suit(card) == suit;
+          })});
+    };
+    tracker.play(0, unseen_of(Suit::H));
+    tracker.play(1, CardSet(std::vector<Card>{hand.to_vector()[0]}));
+    tracker.play(2, unseen_of(Suit::C));
+    REQUIRE(tracker.is_void(2, Suit::H));
+
+    const DealSampler sampler(tracker, 8);
+    REQUIRE(sampler.num_bins() == NUM_SEATS + 1);
+    std::vector<CardSet> bins;
+    for (int n = 0; n < 1000; ++n) {
+      sampler.sample(gen, bins);
+      CHECK(bins[1].empty());
+      CHECK(bins[4].size() == 8);
+      for (int s = 0; s < NUM_SEATS; ++s) {
+        if (s == 1) continue;
+        CHECK(bins[s].size() == tracker.num_cards(s));
+        CHECK(bins[s].is_subset_of(tracker.possible(s)));
+      }
+    }
+  }
+
+  SECTION("wrong constraints") {
+    const CardSet cards(std::vector<Card>{{Suit::H, Rank::_A},
+                                          {Suit::H, Rank::_K}});
+    REQUIRE_THROWS_AS(DealSampler(cards, {cards, cards}, {1, 2}),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(DealSampler(cards, {cards, CardSet()}, {1, 1}),
+                      std::runtime_error);
+    // no bin may take the king
+    const CardSet ace(std::vector<Card>{{Suit::H, Rank::_A}});
+    REQUIRE_THROWS_AS(DealSampler(cards, {ace, ace}, {1, 1}),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(DealSampler(cards, {}, {}), std::runtime_error);
+  }
+}
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/double_dummy.hpp"
+#include "search/moves.hpp"
+#include "search/tests/test_helpers.hpp"
+
+using namespace rankup;
+
+namespace {
+// plain minimax without any pruning, as the reference of the solver
+struct Minimax {
+  const Deal& deal;
+  const Rules& rules;
+  bool with_throws = true;
+  MoveGenerator generator{rules};
+  std::array<CardSet, NUM_SEATS> hands = deal.hands;
+
+  int trick(int leader) {
+    if (hands[leader].empty()) return 0;
+    std::vector<CardSet> leads;
+    generator.leads(hands[leader], leads);
+    if (with_throws) {
+      std::vector<std::vector<Card>> others;
+      for (int i = 1; i < NUM_SEATS; ++i)
+        others.push_back(hands[(leader + i) % NUM_SEATS].to_vector());
+      generator.throws(hands[leader], others, leads);
+    }
+    const bool maximizing = is_attacker(deal, leader);
+    int best = maximizing ? -1 : 1 << 20;
+    for (const auto& lead : leads) {
+      hands[leader] -= lead;
+      auto round = rules.start_round_with(lead.to_vector());
+      const int value = follow(leader, 1, round, leader, lead.points());
+      hands[leader] += lead;
+      best = maximizing ? std::max(best, value) : std::min(best, value);
+    }
+    return best;
+  }
+
+  int follow(int leader, int i, const RoundRules& round, int winner,
+             int points) {
+    if (i == NUM_SEATS) {
+      const bool attackers_win = is_attacker(deal, winner);
+      int gained = attackers_win ? points : 0;
+      if (hands[winner].empty()) {
+        if (attackers_win)
+          gained += deal.kitty.points() *
+                    kitty_multiplier(round.winning_composition());
+        return gained;
+      }
+      return gained + trick(winner);
+    }
+    const int seat = (leader + i) % NUM_SEATS;
+    std::vector<CardSet> moves;
+    generator.follows(round, hands[seat], moves);
+    const bool maximizing = is_attacker(deal, seat);
+    int best = maximizing ? -1 : 1 << 20;
+    for (const auto& move : moves) {
+      auto next = round;
+      const bool wins = next.update_if_defeated_by(move.to_vector());
+      hands[seat] -= move;
+      const int value = follow(leader, i + 1, next, wins ? seat : winner,
+                               points + move.points());
+      hands[seat] += move;
+      best = maximizing ? std::max(best, value) : std::min(best, value);
+    }
+    return best;
+  }
+};
+
+Deal random_deal(std::mt19937_64& gen, int hand_size) {
+  // a few suits and ranks with points keep deals small but interesting
+  std::vector<Card> deck;
+  for (auto suit : {Suit::H, Suit::S, Suit::D}) {
+    for (auto rank : {Rank::_5, Rank::_8, Rank::_10, Rank::_K, Rank::_A}) {
+      deck.emplace_back(suit, rank);
+      deck.emplace_back(suit, rank);
+    }
+  }
+  deck.emplace_back(Suit::J, Rank::_W);
+  std::shuffle(deck.begin(), deck.end(), gen);
+
+  Deal deal;
+  const Card lords[] = {{Suit::S, Rank::_8}, {Suit::H, Rank::_A},
+                        {Suit::J, Rank::_8}, {Suit::J, Rank::_W}};
+  deal.lord_card = lords[gen() % 4];
+  deal.declarer = gen() % NUM_SEATS;
+  test::deal_from(deck, hand_size, 2, deal);
+  return deal;
+}
+}  // namespace
+
+SCENARIO("kitty_multiplier", "[search]") {
+  Composition single(Suit::H);
+  single.insert(0, 3);
+  CHECK(kitty_multiplier(single) == 2);
+
+  Composition tractor(Suit::H);
+  tractor.insert(0, 3);
+  tractor.insert(2, 5);
+  CHECK(kitty_multiplier(tractor) == 8);
+}
+
+SCENARIO("DoubleDummySolver", "[search]") {
+  DoubleDummySolver solver(1 << 20);
+
+  SECTION("a single trick") {
+    Deal deal;
+    deal.lord_card = Card(Suit::S, Rank::_8);
+    deal.declarer = 0;
+    deal.hands[0] = CardSet({{Suit::H, Rank::_5}});
+    deal.hands[1] = CardSet({{Suit::H, Rank::_K}});
+    deal.hands[2] = CardSet({{Suit::H, Rank::_2}});
+    deal.hands[3] = CardSet({{Suit::H, Rank::_10}});
+    deal.kitty = CardSet({{Suit::D, Rank::_10}, {Suit::D, Rank::_3}});
+
+    // the attacker with HK wins 25 points, plus the kitty doubled
+    CHECK(solver.solve(deal, 0) == 45);
+    CHECK(solver.best_move() == deal.hands[0]);
+  }
+
+  SECTION("a throw keeps the last trick from a trump") {
+    Deal deal;
+    deal.lord_card = Card(Suit::S, Rank::_8);
+    deal.declarer = 0;
+    deal.hands[0] = CardSet({{Suit::D, Rank::_3}, {Suit::D, Rank::_4}});
+    deal.hands[1] = CardSet({{Suit::H, Rank::_A}, {Suit::H, Rank::_K}});
+    deal.hands[2] = CardSet({{Suit::H, Rank::_5}, {Suit::S, Rank::_3}});
+    deal.hands[3] = CardSet({{Suit::C, Rank::_3}, {Suit::C, Rank::_4}});
+    deal.kitty = CardSet({{Suit::C, Rank::_K}, {Suit::C, Rank::_6}});
+    const Rules rules(deal.lord_card);
+
+    // led one by one, the hearts give seat 2 a trick to trump
+    Minimax without_throws{deal, rules, false};
+    CHECK(without_throws.trick(1) == 15);
+
+    // thrown together, they take the H5, the K and the kitty doubled
+    Minimax minimax{deal, rules};
+    CHECK(minimax.trick(1) == 35);
+    CHECK(solver.solve(deal, 1) == 35);
+    CHECK(solver.best_move() == deal.hands[1]);
+  }
+
+  SECTION("a throw that fails is not a move") {
+    Deal deal;
+    deal.lord_card = Card(Suit::S, Rank::_8);
+    deal.hands[0] = CardSet({{Suit::H, Rank::_A}, {Suit::H, Rank::_K}});
+    deal.hands[1] = CardSet({{Suit::H, Rank::_A}, {Suit::H, Rank::_5}});
+    const Rules rules(deal.lord_card);
+    const MoveGenerator generator(rules);
+    std::vector<CardSet> moves;
+    generator.throws(deal.hands[0], {deal.hands[1].to_vector()}, moves);
+    CHECK(moves.empty());
+    generator.throws(deal.hands[1], {deal.hands[0].to_vector()}, moves);
+    CHECK(moves.empty());
+    deal.hands[1] = CardSet({{Suit::H, Rank::_Q}, {Suit::H, Rank::_5}});
+    generator.throws(deal.hands[0], {deal.hands[1].to_vector()}, moves);
+    CHECK(moves == std::vector<CardSet>{deal.hands[0]});
+  }
+
+  SECTION("invalid deals") {
+    Deal deal;
+    deal.hands[0] = CardSet({{Suit::H, Rank::_5}});
+    CHECK_THROWS_AS(solver.solve(deal, 0), std::runtime_error);
+    deal.hands[1] = deal.hands[2] = deal.hands[3] = deal.hands[0];
+    CHECK_THROWS_AS(solver.solve(deal, 4), std::runtime_error);
+  }
+
+  SECTION("agrees with plain minimax") {
+    std::mt19937_64 gen(36);
+    for (int n = 0; n < 24; ++n) {
+      const auto deal = random_deal(gen, 2 + n % 2);
+      const Rules rules(deal.lord_card);
+      for (int leader = 0; leader < NUM_SEATS; ++leader) {
+        Minimax minimax{deal, rules};
+        const int expected = minimax.trick(leader);
+        REQUIRE(solver.solve(deal, leader) == expected);
+        CHECK(solver.best_move().is_subset_of(deal.hands[leader]));
+      }
+    }
+  }
+}
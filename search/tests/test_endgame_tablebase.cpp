@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "search/double_dummy.hpp"
+#include "search/endgame_tablebase.hpp"
+#include "search/tests/test_helpers.hpp"
+
+using namespace rankup;
+
+namespace {
+// swap hearts and diamonds
+CardSet swap_h_d(const CardSet& cards) {
+  CardSet res;
+  for (const auto& card : cards.to_vector()) {
+    auto suit = card.suit();
+    if (suit == Suit::H)
+      suit = Suit::D;
+    else if (suit == Suit::D)
+      suit = Suit::H;
+    res.add(Card(suit, card.rank()));
+  }
+  return res;
+}
+}  // namespace
+
+SCENARIO("EndgameTablebase", "[search]") {
+  const Card lord_card(Suit::S, Rank::_8);
+  std::mt19937_64 gen(38);
+  auto deck = test::double_deck();
+  std::vector<CardSet> remainders;
+  for (int r = 0; r < 3; ++r) {
+    std::shuffle(deck.begin(), deck.end(), gen);
+    remainders.push_back(test::cards_from(deck, 0, 8));
+  }
+  const std::vector<int> kitty_points = {0, 25};
+
+  SECTION("wrong arguments") {
+    const std::vector<CardSet> odd = {CardSet({{Suit::H, Rank::_3}})};
+    CHECK_THROWS_AS(EndgameTablebase::build(lord_card, odd),
+                    std::runtime_error);
+    CHECK_THROWS_AS(EndgameTablebase::build(lord_card, remainders, {7}),
+                    std::runtime_error);
+  }
+
+  const auto tablebase =
+      EndgameTablebase::build(lord_card, remainders, kitty_points, 3);
+  REQUIRE(tablebase->size() > 0);
+
+  SECTION("probes agree with the solver") {
+    DoubleDummySolver solver(1 << 20);
+    for (int n = 0; n < 60; ++n) {
+      auto cards = remainders[n % 3].to_vector();
+      std::shuffle(cards.begin(), cards.end(), gen);
+
+      Deal deal;
+      deal.lord_card = lord_card;
+      deal.declarer = gen() % NUM_SEATS;
+      for (int i = 0; i < 8; ++i) deal.hands[i / 2].add(cards[i]);
+      deal.kitty = n % 2 ? CardSet({{Suit::C, Rank::_K},
+                                    {Suit::C, Rank::_10},
+                                    {Suit::D, Rank::_5}})
+                         : CardSet({{Suit::C, Rank::_3}});
+      const int leader = gen() % NUM_SEATS;
+
+      const auto probed = tablebase->probe(deal, leader);
+      REQUIRE(probed);
+      CHECK(*probed == solver.solve(deal, leader));
+
+      THEN("positions equal up to folk suits share the entry") {
+        auto swapped = deal;
+        for (auto& hand : swapped.hands) hand = swap_h_d(hand);
+        CHECK(tablebase->probe(swapped, leader) == probed);
+      }
+    }
+  }
+
+  SECTION("positions not in the tablebase") {
+    Deal deal;
+    deal.lord_card = lord_card;
+    for (auto& hand : deal.hands) hand = CardSet({{Suit::J, Rank::_W}});
+    CHECK_FALSE(tablebase->probe(deal, 0));
+
+    // kitty points not asked for
+    auto cards = remainders[0].to_vector();
+    for (int i = 0; i < 8; ++i) deal.hands[i / 2] = CardSet();
+    for (int i = 0; i < 8; ++i) deal.hands[i / 2].add(cards[i]);
+    CHECK(tablebase->probe(deal, 0));
+    deal.kitty = CardSet({{Suit::C, Rank::_5}});
+    CHECK_FALSE(tablebase->probe(deal, 0));
+  }
+
+  SECTION("written and memory-mapped") {
+    const std::string path = "test_endgame_tablebase.bin";
+    tablebase->write(path);
+    const auto loaded = EndgameTablebase::load(path);
+    CHECK(loaded->size() == tablebase->size());
+
+    Deal deal;
+    deal.lord_card = lord_card;
+    const auto cards = remainders[1].to_vector();
+    for (int i = 0; i < 8; ++i) deal.hands[i % 4].add(cards[i]);
+    CHECK(loaded->probe(deal, 2) == tablebase->probe(deal, 2));
+
+    {
+      // corrupt the last byte
+      std::fstream file(path,
+                        std::ios::in | std::ios::out | std::ios::binary);
+      file.seekp(-1, std::ios::end);
+      file.put('\x7f');
+    }
+    CHECK_THROWS_AS(EndgameTablebase::load(path), std::runtime_error);
+
+    THEN("entries whose check differs aren't found") {
+      {
+        std::fstream file(path,
+                          std::ios::in | std::ios::out | std::ios::binary);
+        for (std::size_t i = 0; i < tablebase->size(); ++i) {
+          file.seekp(64 + 16 * i + 12);
+          file.put('\x5a');
+        }
+      }
+      const auto unchecked = EndgameTablebase::load(path, false);
+      CHECK(tablebase->probe(deal, 2));
+      CHECK_FALSE(unchecked->probe(deal, 2));
+    }
+    std::remove(path.c_str());
+
+    CHECK_THROWS_AS(EndgameTablebase::load(path), std::runtime_error);
+  }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/card_tracker.hpp"
+#include "search/double_dummy.hpp"
+#include "search/play_state.hpp"
+
+// helpers shared by the tests of search
+namespace rankup::test {
+// @return both copies of every card, in the order of Card::index()
+inline std::vector<Card> double_deck() {
+  std::vector<Card> deck;
+  for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+    deck.push_back(Card::from_index(i));
+    deck.push_back(Card::from_index(i));
+  }
+  return deck;
+}
+
+inline std::vector<Card> shuffled_deck(std::mt19937_64& gen) {
+  auto deck = double_deck();
+  std::shuffle(deck.begin(), deck.end(), gen);
+  return deck;
+}
+
+// @return the count cards of deck from first on
+inline CardSet cards_from(const std::vector<Card>& deck, int first,
+                          int count) {
+  return CardSet(
+      std::vector<Card>(deck.begin() + first, deck.begin() + first + count));
+}
+
+// @return hand_size cards of deck for each seat in turn, from the top
+inline std::array<CardSet, NUM_SEATS> hands_from(const std::vector<Card>& deck,
+                                                 int hand_size) {
+  std::array<CardSet, NUM_SEATS> hands;
+  for (int s = 0; s < NUM_SEATS; ++s)
+    hands[s] = cards_from(deck, hand_size * s, hand_size);
+  return hands;
+}
+
+// deal hand_size cards of deck to each seat, then kitty_size to the kitty
+inline void deal_from(const std::vector<Card>& deck, int hand_size,
+                      int kitty_size, Deal& deal) {
+  deal.hands = hands_from(deck, hand_size);
+  deal.kitty = cards_from(deck, NUM_SEATS * hand_size, kitty_size);
+}
+
+/**
+   A position seen by seat 3, which attacks against declarer 0 with spades 2
+   as the lord card, has no hearts but the big joker, and is to follow a
+   trick where seats 0 to 2 played the K, 5 and 10 of hearts. The other
+   hands only hold the cards they played.
+ */
+struct TrumpPosition {
+  CardSet hand;
+  CardTracker tracker;
+  PlayState state;
+};
+
+inline TrumpPosition trump_position(const Rules& rules, std::mt19937_64& gen) {
+  std::vector<Card> deck;
+  for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+    const auto card = Card::from_index(i);
+    if (rules.lorded_suit(card) == Suit::H or card.rank() == Rank::_W)
+      continue;
+    deck.push_back(card);
+    deck.push_back(card);
+  }
+  std::shuffle(deck.begin(), deck.end(), gen);
+  auto hand = cards_from(deck, 0, 24);
+  hand.add({Suit::J, Rank::_W});
+  TrumpPosition res{hand, CardTracker(rules, 3, hand), PlayState()};
+
+  auto& state = res.state;
+  state.deal.lord_card = rules.lord_card();
+  state.deal.declarer = 0;
+  state.deal.hands[3] = hand;
+  state.seat = 0;
+
+  const Card trick[] = {
+      {Suit::H, Rank::_K}, {Suit::H, Rank::_5}, {Suit::H, Rank::_10}};
+  for (int s = 0; s < 3; ++s) {
+    const CardSet move(std::vector<Card>{trick[s]});
+    res.tracker.play(s, move);
+    state.deal.hands[s].add(trick[s]);
+    state.play(rules, move);
+  }
+  return res;
+}
+}  // namespace rankup::test
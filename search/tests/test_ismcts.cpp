@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/card_tracker.hpp"
+#include "search/deal_sampler.hpp"
+#include "search/ismcts.hpp"
+#include "search/move_equivalence.hpp"
+#include "search/moves.hpp"
+#include "search/play_state.hpp"
+#include "search/rollout.hpp"
+#include "search/tests/test_helpers.hpp"
+
+using namespace rankup;
+
+SCENARIO("ISMCTS", "[search]") {
+  const Rules rules(Card(Suit::S, Rank::_2));
+  const MoveGenerator generator(rules);
+  std::mt19937_64 gen(43);
+
+  // seat 3 attacks with no hearts but the big joker, and follows a king of
+  // hearts led by the declarer, which it can trump
+  auto position = test::trump_position(rules, gen);
+  const auto& hand = position.hand;
+  auto& tracker = position.tracker;
+  auto& state = position.state;
+  REQUIRE(state.seat == 3);
+  REQUIRE(state.winner == 0);
+  REQUIRE(state.trick_points == 25);
+
+  Ismcts ismcts(rules);
+  Ismcts::Options options;
+  options.max_iterations = 300;
+  options.time_budget = std::chrono::hours(1);
+  options.seed = 7;
+
+  SECTION("statistics of legal moves") {
+    const auto stats = ismcts.search(tracker, state, options);
+    CHECK(ismcts.num_iterations() == 300);
+    CHECK(ismcts.num_nodes() > stats.size());
+
+    std::vector<CardSet> legal;
+    generator.follows(*state.round, hand, legal);
+    int visits = 0;
+    for (std::size_t i = 0; i < stats.size(); ++i) {
+      CHECK(std::find(legal.begin(), legal.end(), stats[i].move) !=
+            legal.end());
+      if (i > 0) CHECK(stats[i - 1].visits >= stats[i].visits);
+      visits += stats[i].visits;
+    }
+    CHECK(visits == 300);
+
+    THEN("it trumps the trick of 25 points") {
+      auto round = *state.round;
+      CHECK(round.update_if_defeated_by(stats[0].move.to_vector()));
+    }
+  }
+
+  SECTION("searches are reproducible") {
+    options.max_iterations = 50;
+    const auto a = ismcts.search(tracker, state, options);
+    Ismcts other(rules, std::make_unique<GreedyRollout>());
+    const auto b = other.search(tracker, state, options);
+    REQUIRE(a.size() == b.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+      CHECK(a[i].move == b[i].move);
+      CHECK(a[i].visits == b[i].visits);
+      CHECK(a[i].mean_points == b[i].mean_points);
+    }
+  }
+
+  SECTION("random rollouts") {
+    options.max_iterations = 30;
+    Ismcts random(rules, std::make_unique<RandomRollout>());
+    const auto stats = random.search(tracker, state, options);
+    CHECK(random.num_iterations() == 30);
+    CHECK_FALSE(stats.empty());
+  }
+
+  SECTION("equivalent moves compressed") {
+    options.max_iterations = 100;
+    options.compress_moves = true;
+    const auto stats = ismcts.search(tracker, state, options);
+    auto played = tracker.played();
+    played -= state.winning_cards;
+    const MoveEquivalence eq(rules, hand, played);
+    for (std::size_t i = 0; i < stats.size(); ++i)
+      for (std::size_t j = i + 1; j < stats.size(); ++j)
+        CHECK_FALSE(eq.equivalent(stats[i].move, stats[j].move));
+  }
+
+  SECTION("a spent time budget still runs an iteration") {
+    options.max_iterations = 0;
+    options.time_budget = std::chrono::milliseconds(0);
+    const auto stats = ismcts.search(tracker, state, options);
+    CHECK(ismcts.num_iterations() >= 1);
+    CHECK_FALSE(stats.empty());
+  }
+
+  SECTION("searches with a given sampler") {
+    options.max_iterations = 50;
+    const auto a = ismcts.search(tracker, state, options);
+    const DealSampler sampler(tracker, options.kitty_size);
+    const auto b = ismcts.search(sampler, state, options);
+    REQUIRE(a.size() == b.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+      CHECK(a[i].move == b[i].move);
+      CHECK(a[i].visits == b[i].visits);
+    }
+  }
+
+  SECTION("not the turn of the player") {
+    state.seat = 2;
+    REQUIRE_THROWS_AS(ismcts.search(tracker, state, options),
+                      std::runtime_error);
+  }
+}
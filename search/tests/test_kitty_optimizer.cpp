@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/kitty_optimizer.hpp"
+#include "search/tests/test_helpers.hpp"
+
+using namespace rankup;
+
+namespace {
+CardSet random_hand(std::mt19937_64& gen, int size) {
+  return test::cards_from(test::shuffled_deck(gen), 0, size);
+}
+
+// the more points buried, the better
+struct PointsEvaluator : BuryEvaluator {
+  double score(const Rules&, const CardSet&,
+               const CardSet& buried) const override {
+    return buried.points();
+  }
+};
+
+// the best score over every way to bury from hand
+double brute_force(const Rules& rules, const CardSet& hand, int num_to_bury,
+                   const BuryEvaluator& evaluator, int* num_candidates) {
+  double best = -1e300;
+  *num_candidates = 0;
+  for_each_subset(hand, num_to_bury, [&](const CardSet& buried) {
+    auto kept = hand;
+    kept -= buried;
+    best = std::max(best, evaluator.score(rules, kept, buried));
+    ++*num_candidates;
+  });
+  return best;
+}
+}  // namespace
+
+SCENARIO("Bury evaluator", "[search]") {
+  const Rules rules(Card(Suit::S, Rank::_2));
+  const HeuristicBuryEvaluator evaluator;
+  // clubs and a pair of spades, the lords
+  const CardSet hand(std::vector<Card>{{Suit::C, Rank::_3},
+                                       {Suit::C, Rank::_K},
+                                       {Suit::S, Rank::_9},
+                                       {Suit::S, Rank::_9},
+                                       {Suit::H, Rank::_4},
+                                       {Suit::H, Rank::_4},
+                                       {Suit::H, Rank::_5},
+                                       {Suit::H, Rank::_5}});
+  auto score = [&](const std::vector<Card>& cards) {
+    const CardSet buried(cards);
+    auto kept = hand;
+    kept -= buried;
+    return evaluator.score(rules, kept, buried);
+  };
+
+  // a void beats a broken tractor, which beats burying lords
+  const double void_clubs = score({{Suit::C, Rank::_3}, {Suit::C, Rank::_K}});
+  const double broken = score({{Suit::H, Rank::_4}, {Suit::H, Rank::_5}});
+  const double lords = score({{Suit::S, Rank::_9}, {Suit::S, Rank::_9}});
+  CHECK(void_clubs > broken);
+  CHECK(broken > lords);
+  // points are worth keeping
+  CHECK(score({{Suit::C, Rank::_3}}) > score({{Suit::C, Rank::_K}}));
+}
+
+SCENARIO("Kitty optimizer", "[search]") {
+  std::mt19937_64 gen(39);
+  const HeuristicBuryEvaluator heuristic;
+
+  SECTION("exhaustive search finds the best candidates") {
+    for (const auto& lord :
+         {Card(Suit::H, Rank::_7), Card(Suit::J, Rank::_w)}) {
+      const Rules rules(lord);
+      const auto hand = random_hand(gen, 14);
+      int num_candidates = 0;
+      const double expected =
+          brute_force(rules, hand, 6, heuristic, &num_candidates);
+
+      BuryOptions options;
+      options.num_to_bury = 6;
+      options.top_k = 5;
+      options.prune_dominated = false;
+      options.num_threads = 3;
+      options.time_budget = std::chrono::hours(1);
+      const auto res = optimize_bury(rules, hand, heuristic, options);
+      REQUIRE(res.complete);
+      REQUIRE(res.num_evaluated == static_cast<std::uint64_t>(num_candidates));
+      REQUIRE(res.best.size() == 5);
+      CHECK(res.best[0].score == expected);
+      for (std::size_t i = 0; i < res.best.size(); ++i) {
+        CHECK(res.best[i].buried.size() == 6);
+        CHECK(res.best[i].buried.is_subset_of(hand));
+        if (i > 0) CHECK(res.best[i - 1].score >= res.best[i].score);
+      }
+    }
+  }
+
+  SECTION("pruning keeps the best candidate of the heuristic") {
+    const Rules rules(Card(Suit::D, Rank::_Q));
+    for (int n = 0; n < 4; ++n) {
+      const auto hand = random_hand(gen, 17);
+      BuryOptions options;
+      options.top_k = 1;
+      options.time_budget = std::chrono::hours(1);
+      options.prune_dominated = false;
+      const auto full = optimize_bury(rules, hand, heuristic, options);
+      options.prune_dominated = true;
+      const auto pruned = optimize_bury(rules, hand, heuristic, options);
+      CHECK(pruned.num_evaluated < full.num_evaluated);
+      REQUIRE(pruned.best.size() == 1);
+      CHECK(pruned.best[0].score == full.best[0].score);
+    }
+  }
+
+  SECTION("custom evaluator") {
+    const Rules rules(Card(Suit::C, Rank::_10));
+    const auto hand = random_hand(gen, 20);
+    BuryOptions options;
+    options.num_to_bury = 4;
+    options.prune_dominated = false;
+    options.time_budget = std::chrono::hours(1);
+    const auto res = optimize_bury(rules, hand, PointsEvaluator(), options);
+
+    // the most points are from the cards of the most points
+    auto cards = hand.to_vector();
+    std::sort(cards.begin(), cards.end(), [](const Card& a, const Card& b) {
+      return points_of(a) > points_of(b);
+    });
+    int expected = 0;
+    for (int i = 0; i < 4; ++i) expected += points_of(cards[i]);
+    REQUIRE_FALSE(res.best.empty());
+    CHECK(res.best[0].score == expected);
+  }
+
+  SECTION("time budget") {
+    const Rules rules(Card(Suit::S, Rank::_A));
+    const auto hand = random_hand(gen, 33);
+    BuryOptions options;
+    options.time_budget = std::chrono::milliseconds(0);
+    const auto res = optimize_bury(rules, hand, heuristic, options);
+    CHECK_FALSE(res.complete);
+  }
+
+  SECTION("too few cards") {
+    const Rules rules(Card(Suit::S, Rank::_A));
+    const auto hand = random_hand(gen, 5);
+    REQUIRE_THROWS_AS(optimize_bury(rules, hand, heuristic),
+                      std::runtime_error);
+  }
+}
@@ -0,0 +1,82 @@
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules_tables.hpp"
+#include "search/lord_evaluator.hpp"
+
+using namespace rankup;
+
+namespace {
+const std::vector<Card> CANDIDATES = {
+    {Suit::D, Rank::_2}, {Suit::C, Rank::_2}, {Suit::H, Rank::_2},
+    {Suit::S, Rank::_2}, {Suit::J, Rank::_2}};
+
+// long and strong in hearts, with nothing in spades
+CardSet hearts_hand() {
+  CardSet hand;
+  for (auto rank : {Rank::_A, Rank::_K, Rank::_Q, Rank::_J, Rank::_10,
+                    Rank::_9, Rank::_8}) {
+    hand.add({Suit::H, rank});
+    hand.add({Suit::H, rank});
+  }
+  for (auto rank : {Rank::_3, Rank::_4, Rank::_6, Rank::_7})
+    hand.add({Suit::H, rank});
+  for (auto rank : {Rank::_3, Rank::_5, Rank::_7, Rank::_9})
+    hand.add({Suit::C, rank});
+  for (auto rank : {Rank::_4, Rank::_6, Rank::_8})
+    hand.add({Suit::D, rank});
+  return hand;
+}
+}  // namespace
+
+SCENARIO("Lord evaluator", "[search]") {
+  const LordEvaluator evaluator(RulesTables::build());
+  LordEvaluator::Options options;
+  options.num_samples = 24;
+  options.time_budget = std::chrono::hours(1);
+  options.num_threads = 2;
+  options.seed = 40;
+
+  SECTION("the long suit makes the best lord") {
+    const auto hand = hearts_hand();
+    REQUIRE(hand.size() == LordEvaluator::HAND_SIZE);
+    const auto res = evaluator.evaluate(hand, CANDIDATES, options);
+    REQUIRE(res.size() == CANDIDATES.size());
+    for (std::size_t c = 0; c < res.size(); ++c) {
+      CHECK(res[c].lord_card == CANDIDATES[c]);
+      CHECK(res[c].num_samples == options.num_samples);
+      CHECK(res[c].mean_points >= 0);
+      CHECK(res[c].stddev_points >= 0);
+    }
+    CHECK(res[2].mean_points < res[3].mean_points);
+    CHECK(res[2].mean_points < res[0].mean_points);
+  }
+
+  SECTION("results depend on the seed only") {
+    CardSet partial;
+    for (auto rank : {Rank::_2, Rank::_A, Rank::_K, Rank::_5})
+      partial.add({Suit::S, rank});
+    const auto a = evaluator.evaluate(partial, CANDIDATES, options);
+    options.num_threads = 1;
+    const auto b = LordEvaluator().evaluate(partial, CANDIDATES, options);
+    for (std::size_t c = 0; c < a.size(); ++c)
+      CHECK(a[c].mean_points == b[c].mean_points);
+  }
+
+  SECTION("deadline") {
+    options.time_budget = std::chrono::milliseconds(0);
+    const auto res = evaluator.evaluate(hearts_hand(), CANDIDATES, options);
+    for (const auto& eval : res) CHECK(eval.num_samples == 0);
+  }
+
+  SECTION("too many cards") {
+    auto hand = hearts_hand();
+    hand.add({Suit::J, Rank::_W});
+    REQUIRE_THROWS_AS(evaluator.evaluate(hand, CANDIDATES),
+                      std::runtime_error);
+  }
+}
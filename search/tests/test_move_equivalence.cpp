@@ -0,0 +1,147 @@
+#include <catch2/catch.hpp>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/move_equivalence.hpp"
+#include "search/moves.hpp"
+
+using namespace rankup;
+
+namespace {
+CardSet cards(std::vector<Card> cards) { return CardSet(cards); }
+}  // namespace
+
+SCENARIO("move equivalence", "[search]") {
+  const Rules rules(Card(Suit::S, Rank::_2));
+  const MoveGenerator generator(rules);
+  const auto hand = cards({{Suit::H, Rank::_8},
+                           {Suit::H, Rank::_8},
+                           {Suit::H, Rank::_9},
+                           {Suit::H, Rank::_9},
+                           {Suit::H, Rank::_J},
+                           {Suit::H, Rank::_J},
+                           {Suit::H, Rank::_K},
+                           {Suit::D, Rank::_3},
+                           {Suit::C, Rank::_2},
+                           {Suit::D, Rank::_2}});
+
+  GIVEN("no card played") {
+    const MoveEquivalence eq(rules, hand, CardSet());
+    THEN("only cards without anything in play between them are equivalent") {
+      CHECK(eq.class_of({Suit::H, Rank::_8}) ==
+            eq.class_of({Suit::H, Rank::_9}));
+      CHECK(eq.class_of({Suit::H, Rank::_9}) !=
+            eq.class_of({Suit::H, Rank::_J}));
+      // minor lords of the same strength
+      CHECK(eq.class_of({Suit::C, Rank::_2}) ==
+            eq.class_of({Suit::D, Rank::_2}));
+      CHECK(eq.class_of({Suit::H, Rank::_K}) !=
+            eq.class_of({Suit::H, Rank::_J}));
+    }
+  }
+
+  GIVEN("both 10s and queens of hearts played") {
+    const auto played = cards({{Suit::H, Rank::_10},
+                               {Suit::H, Rank::_10},
+                               {Suit::H, Rank::_Q},
+                               {Suit::H, Rank::_Q}});
+    const MoveEquivalence eq(rules, hand, played);
+
+    THEN("the 9s and jacks are of a class, but not the king with points") {
+      CHECK(eq.class_of({Suit::H, Rank::_9}) ==
+            eq.class_of({Suit::H, Rank::_J}));
+      CHECK(eq.class_of({Suit::H, Rank::_8}) ==
+            eq.class_of({Suit::H, Rank::_J}));
+      CHECK(eq.class_of({Suit::H, Rank::_K}) !=
+            eq.class_of({Suit::H, Rank::_J}));
+      CHECK(eq.equivalent(cards({{Suit::H, Rank::_8}}),
+                          cards({{Suit::H, Rank::_9}})));
+      CHECK(eq.equivalent(cards({{Suit::H, Rank::_8}, {Suit::H, Rank::_8}}),
+                          cards({{Suit::H, Rank::_9}, {Suit::H, Rank::_9}})));
+      // but leading jacks keeps the tractor of 8s and 9s
+      CHECK_FALSE(eq.equivalent(cards({{Suit::H, Rank::_9}}),
+                                cards({{Suit::H, Rank::_J}})));
+      CHECK_FALSE(
+          eq.equivalent(cards({{Suit::H, Rank::_9}, {Suit::H, Rank::_9}}),
+                        cards({{Suit::H, Rank::_J}, {Suit::H, Rank::_J}})));
+      CHECK_FALSE(eq.equivalent(
+          cards({{Suit::H, Rank::_9}, {Suit::H, Rank::_J}}),
+          cards({{Suit::H, Rank::_J}, {Suit::H, Rank::_J}})));
+    }
+
+    THEN("tractors still need adjacent strengths") {
+      const auto tractor = cards({{Suit::H, Rank::_8},
+                                  {Suit::H, Rank::_8},
+                                  {Suit::H, Rank::_9},
+                                  {Suit::H, Rank::_9}});
+      const auto pairs = cards({{Suit::H, Rank::_8},
+                                {Suit::H, Rank::_8},
+                                {Suit::H, Rank::_J},
+                                {Suit::H, Rank::_J}});
+      CHECK_FALSE(eq.equivalent(tractor, pairs));
+    }
+
+    THEN("leads compress to one per class") {
+      std::vector<CardSet> moves;
+      generator.leads(hand, moves);
+      const auto num_moves = moves.size();
+      eq.compress(moves);
+      CHECK(moves.size() < num_moves);
+      for (std::size_t i = 0; i < moves.size(); ++i)
+        for (std::size_t j = i + 1; j < moves.size(); ++j)
+          CHECK_FALSE(eq.equivalent(moves[i], moves[j]));
+
+      // singles of 8/9, J, K, D3 and the minor lords, pairs of 8/9 and J,
+      // and the tractor of 8s and 9s. Leading a jack keeps the tractor of 8s
+      // and 9s in the hand.
+      CHECK(moves.size() == 8);
+    }
+  }
+
+  GIVEN("a pair of 9s and a jack, with the 10s and the other jack played") {
+    const auto small = cards(
+        {{Suit::H, Rank::_9}, {Suit::H, Rank::_9}, {Suit::H, Rank::_J}});
+    const auto played = cards(
+        {{Suit::H, Rank::_10}, {Suit::H, Rank::_10}, {Suit::H, Rank::_J}});
+    const MoveEquivalence eq(rules, small, played);
+    THEN("leading a 9, which breaks the pair, isn't leading the jack") {
+      CHECK(eq.class_of({Suit::H, Rank::_9}) ==
+            eq.class_of({Suit::H, Rank::_J}));
+      CHECK_FALSE(eq.equivalent(cards({{Suit::H, Rank::_9}}),
+                                cards({{Suit::H, Rank::_J}})));
+      std::vector<CardSet> moves = {cards({{Suit::H, Rank::_9}}),
+                                    cards({{Suit::H, Rank::_J}})};
+      eq.compress(moves);
+      CHECK(moves.size() == 2);
+    }
+  }
+
+  GIVEN("a 10 winning the current trick") {
+    const auto played = cards({{Suit::H, Rank::_10}});
+    const MoveEquivalence eq(rules, hand, played);
+    THEN("the 9s don't beat it like the jacks") {
+      CHECK(eq.class_of({Suit::H, Rank::_9}) !=
+            eq.class_of({Suit::H, Rank::_J}));
+    }
+  }
+  GIVEN("a cache of move equivalences") {
+    MoveEquivalenceCache cache(rules, 2);
+    const auto played = cards({{Suit::H, Rank::_10}, {Suit::H, Rank::_10}});
+    THEN("it gives the classes of the hand and played cards asked for") {
+      for (int n = 0; n < 3; ++n) {
+        for (const auto& p : {CardSet(), played}) {
+          const MoveEquivalence eq(rules, hand, p);
+          const auto& cached = cache.get(hand, p);
+          for (const auto& card : hand.to_vector())
+            CHECK(cached.class_of(card) == eq.class_of(card));
+        }
+      }
+      CHECK(cache.get(hand, played).class_of({Suit::H, Rank::_9}) ==
+            cache.get(hand, played).class_of({Suit::H, Rank::_J}));
+      CHECK(cache.get(hand, CardSet()).class_of({Suit::H, Rank::_9}) !=
+            cache.get(hand, CardSet()).class_of({Suit::H, Rank::_J}));
+    }
+  }
+}
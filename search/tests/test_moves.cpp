@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/moves.hpp"
+
+using namespace rankup;
+
+namespace {
+int num_with_size(const std::vector<CardSet>& moves, int size) {
+  return std::count_if(moves.begin(), moves.end(),
+                       [size](const auto& move) { return move.size() == size; });
+}
+}  // namespace
+
+SCENARIO("CardSet helpers", "[search]") {
+  const Card a(Suit::C, Rank::_5);
+  const Card b(Suit::C, Rank::_K);
+
+  CHECK(CardSet({a, b, b, {Suit::H, Rank::_10}, {Suit::J, Rank::_W}})
+            .points() == 35);
+
+  std::vector<CardSet> subsets;
+  for_each_subset(CardSet({a, a, b}), 2,
+                  [&subsets](const CardSet& s) { subsets.push_back(s); });
+  REQUIRE(subsets.size() == 2);
+  CHECK(std::count(subsets.begin(), subsets.end(), CardSet({a, a})) == 1);
+  CHECK(std::count(subsets.begin(), subsets.end(), CardSet({a, b})) == 1);
+}
+
+SCENARIO("MoveGenerator", "[search]") {
+  const Rules rules(Card(Suit::S, Rank::_8));
+  const MoveGenerator generator(rules);
+
+  SECTION("masks of lorded suits") {
+    CHECK(generator.cards_of(CardSet({{Suit::H, Rank::_8}, {Suit::H, Rank::_9}}),
+                             Suit::J) == CardSet({{Suit::H, Rank::_8}}));
+  }
+
+  SECTION("leads are singles, pairs and tractors") {
+    const CardSet hand({{Suit::H, Rank::_3},
+                        {Suit::H, Rank::_3},
+                        {Suit::H, Rank::_4},
+                        {Suit::H, Rank::_4},
+                        {Suit::H, Rank::_6},
+                        {Suit::D, Rank::_2}});
+    std::vector<CardSet> moves;
+    generator.leads(hand, moves);
+    CHECK(moves.size() == 7);
+    CHECK(num_with_size(moves, 1) == 4);
+    CHECK(num_with_size(moves, 2) == 2);
+    CHECK(num_with_size(moves, 4) == 1);
+  }
+
+  SECTION("tractors through minor lords") {
+    // strengths: A of spades 11, minor lords 12 and the major lord 13
+    const CardSet hand({{Suit::S, Rank::_A},
+                        {Suit::S, Rank::_A},
+                        {Suit::H, Rank::_8},
+                        {Suit::H, Rank::_8},
+                        {Suit::D, Rank::_8},
+                        {Suit::D, Rank::_8},
+                        {Suit::S, Rank::_8},
+                        {Suit::S, Rank::_8}});
+    std::vector<CardSet> moves;
+    generator.leads(hand, moves);
+    CHECK(num_with_size(moves, 4) == 4);
+    CHECK(num_with_size(moves, 6) == 2);
+    for (const auto& move : moves) {
+      if (move.size() < 4) continue;
+      const auto round = rules.start_round_with(move.to_vector());
+      CHECK(round.format().get_count_at_or_0(move.size() / 2) == 1);
+    }
+  }
+
+  SECTION("follows") {
+    const auto round = rules.start_round_with(
+        {{Suit::H, Rank::_9}, {Suit::H, Rank::_9}});
+    std::vector<CardSet> moves;
+
+    WHEN("the hand has a pair of the suit") {
+      generator.follows(round,
+                        CardSet({{Suit::H, Rank::_3},
+                                 {Suit::H, Rank::_3},
+                                 {Suit::H, Rank::_5},
+                                 {Suit::H, Rank::_K},
+                                 {Suit::D, Rank::_2},
+                                 {Suit::S, Rank::_J}}),
+                        moves);
+      REQUIRE(moves.size() == 1);
+      CHECK(moves[0] == CardSet({{Suit::H, Rank::_3}, {Suit::H, Rank::_3}}));
+    }
+
+    WHEN("the hand has singles of the suit only") {
+      generator.follows(round,
+                        CardSet({{Suit::H, Rank::_5},
+                                 {Suit::H, Rank::_Q},
+                                 {Suit::H, Rank::_K},
+                                 {Suit::D, Rank::_2},
+                                 {Suit::D, Rank::_2}}),
+                        moves);
+      CHECK(moves.size() == 3);
+    }
+
+    WHEN("the hand is short of the suit") {
+      generator.follows(round,
+                        CardSet({{Suit::H, Rank::_5},
+                                 {Suit::D, Rank::_2},
+                                 {Suit::D, Rank::_3},
+                                 {Suit::H, Rank::_8}}),
+                        moves);
+      // H8 is a lord, so it may fill in as well as the diamonds
+      CHECK(moves.size() == 3);
+      for (const auto& move : moves)
+        CHECK(move.contains({Suit::H, Rank::_5}));
+    }
+  }
+}
@@ -0,0 +1,75 @@
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "search/node_arena.hpp"
+
+using namespace rankup;
+
+SCENARIO("node arena", "[search]") {
+  const CardSet a(std::vector<Card>{{Suit::S, Rank::_A}});
+  const CardSet b(std::vector<Card>{{Suit::H, Rank::_3}, {Suit::H, Rank::_3}});
+  const CardSet c(std::vector<Card>{{Suit::J, Rank::_W}});
+  NodeArena arena(2);
+  REQUIRE(arena.size() == 1);
+  REQUIRE_FALSE(arena[0].expanded());
+
+  SECTION("children expanded at once are contiguous") {
+    const auto first = arena.expand(0, {a, b});
+    CHECK(first == 1);
+    CHECK(arena[0].first_child == 1);
+    CHECK(arena[1].next_sibling == 2);
+    CHECK(arena[2].next_sibling == NodeArena::NONE);
+    CHECK(arena.move(1) == a);
+    CHECK(arena.move(2) == b);
+    CHECK(arena.find_child(0, b) == 2);
+    CHECK(arena.find_child(0, c) == NodeArena::NONE);
+    CHECK(arena.find_child(1, a) == NodeArena::NONE);
+
+    // growing past the capacity keeps the tree
+    arena[2].visits = 5;
+    arena[2].score = 1.5;
+    CHECK(arena.expand(2, {c, a, b}) == 3);
+    CHECK(arena.size() == 6);
+    CHECK(arena.capacity() >= 6);
+    CHECK(arena[2].visits == 5);
+    CHECK(arena[2].score == 1.5);
+    CHECK(arena.move(3) == c);
+    CHECK(arena.find_child(2, b) == 5);
+
+    REQUIRE_THROWS_AS(arena.expand(0, {c}), std::runtime_error);
+  }
+
+  SECTION("children added one at a time") {
+    const auto first = arena.add_child(0, a);
+    arena[first].visits = 2;
+    const auto second = arena.add_child(0, b);
+    CHECK(arena[0].first_child == second);
+    CHECK(arena[second].next_sibling == first);
+    CHECK(arena.find_child(0, a) == first);
+    CHECK(arena.find_child(0, b) == second);
+    CHECK(arena[first].visits == 2);
+    CHECK(arena[second].visits == 0);
+
+    // a child of a child, past the capacity
+    const auto grandchild = arena.add_child(first, c);
+    CHECK(arena.size() == 4);
+    CHECK(arena.find_child(first, c) == grandchild);
+    CHECK(arena.find_child(0, c) == NodeArena::NONE);
+  }
+
+  SECTION("reset keeps the memory") {
+    arena.expand(0, {a, b, c});
+    arena[1].visits = 3;
+    const auto capacity = arena.capacity();
+    arena.reset();
+    CHECK(arena.size() == 1);
+    CHECK(arena.capacity() == capacity);
+    CHECK_FALSE(arena[0].expanded());
+    CHECK(arena.expand(0, {b}) == 1);
+    CHECK(arena[1].visits == 0);
+    CHECK(arena.move(1) == b);
+  }
+}
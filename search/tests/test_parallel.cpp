@@ -0,0 +1,41 @@
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <vector>
+
+#include "search/parallel.hpp"
+
+using namespace rankup;
+
+SCENARIO("parallel_for", "[search]") {
+  CHECK(resolve_num_threads(3) == 3);
+  CHECK(resolve_num_threads(0) >= 1);
+
+  SECTION("every task runs once") {
+    std::vector<std::atomic<int>> runs(1000);
+    std::atomic<int> max_thread{0};
+    parallel_for(runs.size(), 8, [&](std::size_t task, int thread) {
+      ++runs[task];
+      int m = max_thread;
+      while (thread > m and !max_thread.compare_exchange_weak(m, thread)) {
+      }
+    });
+    for (const auto& r : runs) CHECK(r == 1);
+    CHECK(max_thread < 8);
+  }
+
+  SECTION("no tasks") {
+    int num_runs = 0;
+    parallel_for(0, 4, [&num_runs](std::size_t, int) { ++num_runs; });
+    CHECK(num_runs == 0);
+  }
+
+  SECTION("exceptions are rethrown") {
+    CHECK_THROWS_AS(parallel_for(100, 4,
+                                 [](std::size_t task, int) {
+                                   if (task == 42)
+                                     throw std::runtime_error("task 42");
+                                 }),
+                    std::runtime_error);
+  }
+}
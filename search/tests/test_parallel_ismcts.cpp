@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/card_tracker.hpp"
+#include "search/moves.hpp"
+#include "search/parallel_ismcts.hpp"
+#include "search/play_state.hpp"
+#include "search/tests/test_helpers.hpp"
+
+using namespace rankup;
+
+SCENARIO("parallel ISMCTS", "[search]") {
+  const Rules rules(Card(Suit::S, Rank::_2));
+  const MoveGenerator generator(rules);
+  std::mt19937_64 gen(43);
+
+  // seat 3 attacks with no hearts but the big joker, and follows a king of
+  // hearts led by the declarer, which it can trump
+  auto position = test::trump_position(rules, gen);
+  const auto& hand = position.hand;
+  auto& tracker = position.tracker;
+  auto& state = position.state;
+
+  std::vector<CardSet> legal;
+  generator.follows(*state.round, hand, legal);
+
+  ParallelIsmcts search(rules);
+  ParallelIsmcts::Options options;
+  options.max_iterations = 300;
+  options.time_budget = std::chrono::hours(1);
+  options.seed = 7;
+
+  for (const auto mode :
+       {ParallelIsmcts::Mode::ROOT, ParallelIsmcts::Mode::TREE}) {
+    for (const int threads : {1, 3}) {
+      options.mode = mode;
+      options.num_threads = threads;
+      DYNAMIC_SECTION("mode " << static_cast<int>(mode) << " on " << threads
+                              << " threads") {
+        const auto stats = search.search(tracker, state, options);
+        CHECK(search.num_iterations() == 300);
+
+        int visits = 0;
+        for (std::size_t i = 0; i < stats.size(); ++i) {
+          CHECK(std::find(legal.begin(), legal.end(), stats[i].move) !=
+                legal.end());
+          if (i > 0) CHECK(stats[i - 1].visits >= stats[i].visits);
+          CHECK(stats[i].mean_points >= 0);
+          visits += stats[i].visits;
+        }
+        CHECK(visits == 300);
+
+        THEN("it trumps the trick of 25 points") {
+          auto round = *state.round;
+          CHECK(round.update_if_defeated_by(stats[0].move.to_vector()));
+        }
+      }
+    }
+  }
+
+  SECTION("a full tree stops expanding") {
+    options.mode = ParallelIsmcts::Mode::TREE;
+    options.num_threads = 2;
+    options.max_nodes = 4;
+    const auto stats = search.search(tracker, state, options);
+    CHECK(stats.size() <= 3);
+    CHECK(search.num_iterations() == 300);
+  }
+
+  SECTION("a spent time budget still runs iterations") {
+    options.num_threads = 2;
+    options.max_iterations = 0;
+    options.time_budget = std::chrono::milliseconds(0);
+    for (const auto mode :
+         {ParallelIsmcts::Mode::ROOT, ParallelIsmcts::Mode::TREE}) {
+      options.mode = mode;
+      const auto stats = search.search(tracker, state, options);
+      CHECK(search.num_iterations() >= 1);
+      CHECK_FALSE(stats.empty());
+    }
+  }
+
+  SECTION("not the turn of the player") {
+    state.seat = 2;
+    REQUIRE_THROWS_AS(search.search(tracker, state, options),
+                      std::runtime_error);
+  }
+}
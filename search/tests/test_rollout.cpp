@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <random>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/moves.hpp"
+#include "search/play_state.hpp"
+#include "search/rollout.hpp"
+#include "search/tests/test_helpers.hpp"
+
+using namespace rankup;
+
+namespace {
+PlayState deal_at_random(const Rules& rules, std::mt19937_64& gen) {
+  PlayState state;
+  state.deal.lord_card = rules.lord_card();
+  state.deal.declarer = 0;
+  test::deal_from(test::shuffled_deck(gen), 25, 8, state.deal);
+  return state;
+}
+
+CardSet cards(std::vector<Card> cards) { return CardSet(cards); }
+}  // namespace
+
+SCENARIO("heuristic rollout", "[search]") {
+  const Rules rules(Card(Suit::S, Rank::_2));
+  const MoveGenerator generator(rules);
+  HeuristicRollout policy;
+
+  SECTION("whole deals of legal moves") {
+    std::mt19937_64 gen(5);
+    for (int game = 0; game < 10; ++game) {
+      auto state = deal_at_random(rules, gen);
+      std::vector<CardSet> moves;
+      while (!state.finished()) {
+        const auto move = policy.choose(generator, state, gen);
+        const auto& hand = state.deal.hands[state.seat];
+        moves.clear();
+        if (state.round) {
+          // MoveGenerator::follows enumerates subsets, so only check the
+          // number of cards and the cards of the led suit of large follows
+          const auto& format = state.round->format();
+          REQUIRE(move.size() == format.total_num_cards());
+          REQUIRE(move.is_subset_of(hand));
+          const auto suited = generator.cards_of(hand, *format.suit());
+          CHECK(generator.cards_of(move, *format.suit()).size() ==
+                std::min(suited.size(), move.size()));
+          if (move.size() <= 2) {
+            generator.follows(*state.round, hand, moves);
+            CHECK(std::find(moves.begin(), moves.end(), move) != moves.end());
+          } else if (suited.size() > move.size()) {
+            // the pairs and tractors of the move are those required
+            const auto required =
+                state.round->get_required_format(hand.to_vector());
+            CHECK(required.is_covered_by(
+                rules.start_round_with(move.to_vector()).format()));
+          }
+        } else {
+          generator.leads(hand, moves);
+          REQUIRE(std::find(moves.begin(), moves.end(), move) != moves.end());
+        }
+        state.play(rules, move);
+      }
+      CHECK(state.points >= 0);
+    }
+  }
+
+  SECTION("games are reproducible given the seed") {
+    std::mt19937_64 deal_gen(9);
+    const auto start = deal_at_random(rules, deal_gen);
+    auto a = start;
+    auto b = start;
+    std::mt19937_64 gen_a(3), gen_b(3);
+    HeuristicRollout other;
+    CHECK(play_out(generator, a, policy, gen_a) ==
+          play_out(generator, b, other, gen_b));
+  }
+
+  GIVEN("a position to lead") {
+    PlayState state;
+    state.deal.lord_card = rules.lord_card();
+    state.deal.declarer = 0;
+    state.seat = 0;
+    std::mt19937_64 gen(1);
+
+    WHEN("the opponents hold no higher pair") {
+      state.deal.hands[0] = cards({{Suit::H, Rank::_K},
+                                   {Suit::H, Rank::_K},
+                                   {Suit::H, Rank::_3},
+                                   {Suit::D, Rank::_A}});
+      state.deal.hands[1] = cards({{Suit::H, Rank::_A},
+                                   {Suit::H, Rank::_4},
+                                   {Suit::D, Rank::_4},
+                                   {Suit::D, Rank::_5}});
+      state.deal.hands[2] = cards({{Suit::H, Rank::_A},
+                                   {Suit::H, Rank::_A},
+                                   {Suit::D, Rank::_3},
+                                   {Suit::D, Rank::_6}});
+      state.deal.hands[3] = cards({{Suit::H, Rank::_Q},
+                                   {Suit::H, Rank::_Q},
+                                   {Suit::D, Rank::_7},
+                                   {Suit::D, Rank::_8}});
+      THEN("it leads the pair of kings, which only the partner beats") {
+        CHECK(policy.choose(generator, state, gen) ==
+              cards({{Suit::H, Rank::_K}, {Suit::H, Rank::_K}}));
+      }
+    }
+
+    WHEN("a void opponent can trump") {
+      state.deal.hands[0] = cards({{Suit::H, Rank::_A},
+                                   {Suit::H, Rank::_3},
+                                   {Suit::D, Rank::_4}});
+      state.deal.hands[1] = cards({{Suit::S, Rank::_3},
+                                   {Suit::D, Rank::_5},
+                                   {Suit::D, Rank::_6}});
+      state.deal.hands[2] = cards({{Suit::H, Rank::_4},
+                                   {Suit::D, Rank::_7},
+                                   {Suit::D, Rank::_8}});
+      state.deal.hands[3] = cards({{Suit::H, Rank::_5},
+                                   {Suit::D, Rank::_9},
+                                   {Suit::D, Rank::_10}});
+      THEN("no ace is unbeatable, so it leads a cheap card") {
+        const auto move = policy.choose(generator, state, gen);
+        CHECK(move.size() == 1);
+        CHECK_FALSE(move.contains({Suit::H, Rank::_A}));
+      }
+    }
+  }
+
+  GIVEN("a trick of a single") {
+    PlayState state;
+    state.deal.lord_card = rules.lord_card();
+    state.deal.declarer = 0;
+    state.deal.hands[0] = cards({{Suit::H, Rank::_9}, {Suit::C, Rank::_3}});
+    state.deal.hands[1] = cards({{Suit::H, Rank::_A}, {Suit::C, Rank::_4}});
+    state.deal.hands[2] = cards({{Suit::H, Rank::_10}, {Suit::H, Rank::_4}});
+    state.deal.hands[3] = cards({{Suit::H, Rank::_K}, {Suit::H, Rank::_Q}});
+    std::mt19937_64 gen(1);
+    state.play(rules, cards({{Suit::H, Rank::_9}}));
+
+    THEN("an opponent takes it with the cheapest card that does") {
+      CHECK(policy.choose(generator, state, gen) ==
+            cards({{Suit::H, Rank::_A}}));
+    }
+
+    WHEN("the partner wins it") {
+      state.play(rules, cards({{Suit::H, Rank::_A}}));
+      THEN("points go to the partner") {
+        CHECK(state.winning_cards == cards({{Suit::H, Rank::_A}}));
+        state.play(rules, cards({{Suit::H, Rank::_4}}));
+        CHECK(policy.choose(generator, state, gen) ==
+              cards({{Suit::H, Rank::_K}}));
+      }
+    }
+  }
+}
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <random>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/play_state.hpp"
+#include "search/suit_symmetry.hpp"
+#include "search/tests/test_helpers.hpp"
+
+using namespace rankup;
+
+SCENARIO("suit symmetry", "[search]") {
+  const Rules rules(Card(Suit::S, Rank::_2));
+  std::mt19937_64 gen(17);
+
+  auto hands = test::hands_from(test::shuffled_deck(gen), 6);
+
+  // a relabeling of the folk suits other than spades
+  SuitPermutation perm;
+  perm.to[static_cast<int>(Suit::D)] = Suit::H;
+  perm.to[static_cast<int>(Suit::C)] = Suit::D;
+  perm.to[static_cast<int>(Suit::H)] = Suit::C;
+
+  SECTION("permutations") {
+    CHECK(perm(Card(Suit::D, Rank::_5)) == Card(Suit::H, Rank::_5));
+    CHECK(perm(Card(Suit::S, Rank::_5)) == Card(Suit::S, Rank::_5));
+    CHECK(perm(Card(Suit::J, Rank::_W)) == Card(Suit::J, Rank::_W));
+    for (const auto& hand : hands) {
+      const auto relabeled = perm(hand);
+      CHECK(relabeled.size() == hand.size());
+      CHECK(relabeled.points() == hand.points());
+      CHECK(perm.inverse()(relabeled) == hand);
+    }
+    CHECK_FALSE(perm.is_identity());
+    CHECK(SuitPermutation().inverse().is_identity());
+  }
+
+  SECTION("relabeled hands have the same canonical form") {
+    std::array<CardSet, NUM_SEATS> relabeled;
+    for (int s = 0; s < NUM_SEATS; ++s) relabeled[s] = perm(hands[s]);
+    const auto a =
+        canonical_suits(rules.lord_card(), hands.data(), NUM_SEATS);
+    const auto b =
+        canonical_suits(rules.lord_card(), relabeled.data(), NUM_SEATS);
+    CHECK(a.to[static_cast<int>(Suit::S)] == Suit::S);
+    CHECK(a.to[static_cast<int>(Suit::J)] == Suit::J);
+    for (int s = 0; s < NUM_SEATS; ++s) CHECK(a(hands[s]) == b(relabeled[s]));
+  }
+
+  GIVEN("a trick in progress") {
+    PlayState state;
+    state.deal.lord_card = rules.lord_card();
+    state.deal.declarer = 0;
+    state.deal.hands[0] = CardSet(std::vector<Card>{
+        {Suit::C, Rank::_3}, {Suit::D, Rank::_A}, {Suit::H, Rank::_A}});
+    state.deal.hands[1] = CardSet(std::vector<Card>{
+        {Suit::C, Rank::_4}, {Suit::D, Rank::_K}, {Suit::H, Rank::_K}});
+    state.deal.hands[2] = CardSet(std::vector<Card>{
+        {Suit::D, Rank::_4}, {Suit::D, Rank::_5}, {Suit::H, Rank::_6}});
+    state.deal.hands[3] = CardSet(std::vector<Card>{
+        {Suit::H, Rank::_4}, {Suit::H, Rank::_5}, {Suit::D, Rank::_6}});
+    state.play(rules, CardSet(std::vector<Card>{{Suit::C, Rank::_3}}));
+    CardSet played(std::vector<Card>{{Suit::C, Rank::_3}});
+
+    WHEN("it is canonicalized") {
+      auto canonical = state;
+      auto canonical_played = played;
+      const auto res = canonicalize(canonical, canonical_played);
+
+      THEN("the led suit comes first and the round follows the relabeling") {
+        CHECK(res.to[static_cast<int>(Suit::C)] == Suit::D);
+        CHECK(*canonical.round->format().suit() == Suit::D);
+        CHECK(canonical.winning_cards ==
+              CardSet(std::vector<Card>{{Suit::D, Rank::_3}}));
+        CHECK(canonical_played == res(played));
+        for (int s = 0; s < NUM_SEATS; ++s)
+          CHECK(canonical.deal.hands[s] == res(state.deal.hands[s]));
+      }
+
+      THEN("play continues the same under the inverse") {
+        const auto move = CardSet(std::vector<Card>{{Suit::D, Rank::_4}});
+        canonical.play(rules, move);
+        CHECK(canonical.winner == 1);
+        canonical.play(rules, res(CardSet(
+                                  std::vector<Card>{{Suit::D, Rank::_4}})));
+        state.play(rules, res.inverse()(move));
+        state.play(rules, CardSet(std::vector<Card>{{Suit::D, Rank::_4}}));
+        CHECK(canonical.winner == state.winner);
+        CHECK(canonical.round->hash() ==
+              state.round->relabeled(res.to).hash());
+      }
+
+      THEN("relabeled positions have the same canonical form") {
+        auto other = state;
+        for (auto& hand : other.deal.hands) hand = perm(hand);
+        other.winning_cards = perm(other.winning_cards);
+        other.round.emplace(other.round->relabeled(perm.to));
+        auto other_played = perm(played);
+        canonicalize(other, other_played);
+        CHECK(other_played == canonical_played);
+        CHECK(other.round->hash() == canonical.round->hash());
+        for (int s = 0; s < NUM_SEATS; ++s)
+          CHECK(other.deal.hands[s] == canonical.deal.hands[s]);
+      }
+    }
+  }
+}
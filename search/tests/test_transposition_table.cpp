@@ -0,0 +1,139 @@
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "search/transposition_table.hpp"
+
+using namespace rankup;
+
+namespace {
+using Entry = TranspositionTable::Entry;
+using Bound = TranspositionTable::Bound;
+
+Entry make_entry(std::int16_t value, std::uint8_t depth,
+                 Bound bound = Bound::EXACT) {
+  Entry entry;
+  entry.value = value;
+  entry.depth = depth;
+  entry.bound = bound;
+  return entry;
+}
+
+// an entry that can be told from the key alone
+Entry entry_of(Zobrist::Key key) {
+  auto entry = make_entry(static_cast<std::int16_t>(key >> 48),
+                          static_cast<std::uint8_t>(key >> 40));
+  entry.best_move = CardSet(key * 3, key * 5);
+  return entry;
+}
+}  // namespace
+
+namespace rankup {
+bool operator==(const TranspositionTable::Entry& a,
+                const TranspositionTable::Entry& b) {
+  return a.value == b.value and a.depth == b.depth and a.bound == b.bound and
+         a.best_move == b.best_move;
+}
+}  // namespace rankup
+
+SCENARIO("TranspositionTable", "[search]") {
+  SECTION("memory budget") {
+    CHECK_THROWS_AS(TranspositionTable(32), std::runtime_error);
+
+    const TranspositionTable table(1000);
+    CHECK(table.memory() == 512);
+    CHECK(table.num_entries() == 16);
+  }
+
+  SECTION("stored entries are probed") {
+    TranspositionTable table(1 << 16);
+    auto entry = make_entry(-37, 12, Bound::LOWER);
+    entry.best_move = CardSet({{Suit::H, Rank::_3}, {Suit::H, Rank::_3}});
+    table.store(0x1234, entry);
+
+    const auto probed = table.probe(0x1234);
+    REQUIRE(probed);
+    CHECK(*probed == entry);
+
+    CHECK_FALSE(table.probe(0x4321));
+    // the same bucket but a different key
+    CHECK_FALSE(table.probe(0x1234 + (std::uint64_t(1) << 40)));
+    CHECK(table.occupancy() > 0);
+
+    table.clear();
+    CHECK_FALSE(table.probe(0x1234));
+    CHECK(table.occupancy() == 0);
+  }
+
+  SECTION("depth preferred replacement") {
+    // a single bucket of two entries
+    TranspositionTable table(64);
+    table.store(1, make_entry(1, 5));
+    table.store(2, make_entry(2, 3));
+    CHECK(table.probe(1));
+    CHECK(table.probe(2));
+
+    // too shallow to replace the deep entry
+    table.store(3, make_entry(3, 2));
+    CHECK(table.probe(1));
+    CHECK_FALSE(table.probe(2));
+    CHECK(table.probe(3));
+
+    // deep enough to replace the deep entry
+    table.store(4, make_entry(4, 5));
+    CHECK_FALSE(table.probe(1));
+    CHECK(table.probe(4));
+
+    // entries of previous searches are replaced regardless of depth
+    table.new_search();
+    table.store(5, make_entry(5, 0));
+    CHECK_FALSE(table.probe(4));
+    CHECK(table.probe(5)->value == 5);
+  }
+
+  SECTION("always replace") {
+    TranspositionTable table(64, TranspositionTable::Replacement::ALWAYS);
+    table.store(1, make_entry(1, 5));
+    table.store(2, make_entry(2, 3));
+    table.store(3, make_entry(3, 9));
+    CHECK(table.probe(1));
+    CHECK_FALSE(table.probe(2));
+    CHECK(table.probe(3));
+
+    // the same position is overwritten even by a shallower entry
+    table.store(3, make_entry(-3, 1));
+    CHECK(table.probe(3)->value == -3);
+    CHECK(table.probe(1));
+  }
+
+  SECTION("64 threads never read torn entries") {
+    // a small table makes threads fight over the same buckets
+    TranspositionTable table(64 * 64);
+    std::atomic<int> num_hits{0};
+    std::atomic<int> num_torn{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 64; ++t) {
+      threads.emplace_back([&table, &num_hits, &num_torn, t]() {
+        std::mt19937_64 gen(t % 4);
+        for (int n = 0; n < 20000; ++n) {
+          const auto key = gen() % 4096 * 0x9e3779b97f4a7c15ULL;
+          table.prefetch(key);
+          if (n % 2) {
+            table.store(key, entry_of(key));
+          } else if (auto entry = table.probe(key)) {
+            ++num_hits;
+            if (!(*entry == entry_of(key))) ++num_torn;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+    CHECK(num_hits > 0);
+    CHECK(num_torn == 0);
+  }
+}
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/card.hpp"
+#include "common/card_set.hpp"
+#include "rules/rules.hpp"
+#include "search/tests/test_helpers.hpp"
+#include "search/zobrist.hpp"
+
+using namespace rankup;
+
+namespace rankup {
+class TestRules {
+ public:
+  static auto parse(const Rules& rules, const std::vector<Card>& cards) {
+    return rules.parse_for_single_suit(cards)->direct_append_extra();
+  }
+};
+}  // namespace rankup
+
+namespace {
+}  // namespace
+
+SCENARIO("std::hash<Card>", "[search]") {
+  std::unordered_set<Card> cards;
+  for (int8_t i = 0; i < NUM_CARD_KINDS; ++i) {
+    cards.insert(Card::from_index(i));
+    cards.insert(Card::from_index(i));
+  }
+  CHECK(cards.size() == NUM_CARD_KINDS);
+  CHECK(cards.count(Card(Suit::J, Rank::_W)) == 1);
+}
+
+SCENARIO("CardSet", "[search]") {
+  const Card c1(Suit::H, Rank::_9);
+  const Card c2(Suit::J, Rank::_w);
+  CardSet set({c1, c2, c1});
+
+  CHECK(set.count(c1) == 2);
+  CHECK(set.count(c2) == 1);
+  CHECK(set.count(Card(Suit::D, Rank::_2)) == 0);
+  CHECK(set.size() == 3);
+  CHECK(set.to_vector() == std::vector<Card>{c1, c1, c2});
+
+  set.remove(c1);
+  CHECK(set.count(c1) == 1);
+  set.remove(c1);
+  CHECK_FALSE(set.contains(c1));
+
+  CardSet a({c1, c1, c2});
+  const CardSet b({c1, c2});
+  CHECK(b.is_subset_of(a));
+  CHECK_FALSE(a.is_subset_of(b));
+  a -= b;
+  CHECK(a == CardSet({c1}));
+  a += b;
+  CHECK(a == CardSet({c1, c1, c2}));
+
+  CardSet pair;
+  pair += CardSet({c1, c1});
+  CHECK(pair.count(c1) == 2);
+}
+
+SCENARIO("Zobrist hashing of hands", "[search]") {
+  std::mt19937_64 gen(34);
+  auto deck = test::double_deck();
+
+  SECTION("incremental hashes agree with hashes from scratch") {
+    std::shuffle(deck.begin(), deck.end(), gen);
+    ZobristHand hand(2);
+    for (int i = 0; i < 25; ++i) hand.add(deck[i]);
+    CHECK(hand.hash() == Zobrist::hash(2, hand.cards()));
+
+    for (int i = 0; i < 25; i += 2) {
+      hand.remove(deck[i]);
+      REQUIRE(hand.hash() == Zobrist::hash(2, hand.cards()));
+    }
+
+    ZobristHand empty(2);
+    CHECK(empty.hash() == 0);
+  }
+
+  SECTION("hashes don't depend on the order of cards") {
+    std::shuffle(deck.begin(), deck.end(), gen);
+    std::vector<Card> cards(deck.begin(), deck.begin() + 25);
+    ZobristHand hand(0);
+    for (const auto& card : cards) hand.add(card);
+
+    std::shuffle(cards.begin(), cards.end(), gen);
+    ZobristHand hand_shuffled(0);
+    for (const auto& card : cards) hand_shuffled.add(card);
+
+    CHECK(hand.hash() == hand_shuffled.hash());
+  }
+
+  SECTION("seats have different keys") {
+    const CardSet cards({{Suit::D, Rank::_5}});
+    for (int s = 0; s < NUM_SEATS; ++s) {
+      for (int t = s + 1; t < NUM_SEATS; ++t) {
+        CHECK(Zobrist::hash(s, cards) != Zobrist::hash(t, cards));
+        CHECK(Zobrist::turn_key(s) != Zobrist::turn_key(t));
+      }
+    }
+  }
+
+  SECTION("the two copies of a card have different keys") {
+    const Card card(Suit::C, Rank::_Q);
+    CHECK(Zobrist::key(1, card, 0) != Zobrist::key(1, card, 1));
+    CHECK(Zobrist::hash(1, CardSet({card, card})) ==
+          (Zobrist::key(1, card, 0) ^ Zobrist::key(1, card, 1)));
+  }
+
+  SECTION("no collisions among many random hands") {
+    std::unordered_map<Zobrist::Key, CardSet> seen;
+    int num_collisions = 0;
+    for (int n = 0; n < 200000; ++n) {
+      std::shuffle(deck.begin(), deck.end(), gen);
+      const auto size = 1 + n % 25;
+      const CardSet cards(
+          std::vector<Card>(deck.begin(), deck.begin() + size));
+      const auto [it, inserted] = seen.emplace(Zobrist::hash(3, cards), cards);
+      if (!inserted and it->second != cards) ++num_collisions;
+    }
+    CHECK(num_collisions == 0);
+  }
+}
+
+SCENARIO("Hashing of trick states", "[search]") {
+  const Rules rules(Card(Suit::S, Rank::_8));
+
+  SECTION("compositions hash independent of the order of insertion") {
+    Composition a(Suit::H);
+    a.insert(0, 3);
+    a.insert(2, 5);
+    a.insert(0, 9);
+    Composition b(Suit::H);
+    b.insert(2, 5);
+    b.insert(0, 9);
+    b.insert(0, 3);
+    REQUIRE(a == b);
+    CHECK(a.hash() == b.hash());
+    CHECK(a.format().hash() == b.format().hash());
+
+    Composition c(Suit::D);
+    c.insert(2, 5);
+    c.insert(0, 9);
+    c.insert(0, 3);
+    CHECK(a.hash() != c.hash());
+  }
+
+  SECTION("repeated components are counted") {
+    Composition a(Suit::J);
+    a.insert(1, 12);
+    Composition b(Suit::J);
+    b.insert(1, 12);
+    b.insert(1, 12);
+    CHECK(a.hash() != b.hash());
+  }
+
+  SECTION("the trick state changes when the winner changes") {
+    const std::vector<Card> first = {{Suit::H, Rank::_9}, {Suit::H, Rank::_9}};
+    auto round = rules.start_round_with(first);
+    const auto round_copy = rules.start_round_with(first);
+    const auto hash_first = Zobrist::hash(round);
+    CHECK(hash_first == Zobrist::hash(round_copy));
+
+    // a pair of the same suit with a higher rank wins
+    CHECK(round.update_if_defeated_by(
+        {{Suit::H, Rank::_K}, {Suit::H, Rank::_K}}));
+    const auto hash_second = Zobrist::hash(round);
+    CHECK(hash_second != hash_first);
+
+    // trumping with a pair of lords wins
+    CHECK(round.update_if_defeated_by(
+        {{Suit::S, Rank::_3}, {Suit::S, Rank::_3}}));
+    CHECK(Zobrist::hash(round) != hash_second);
+    CHECK(Zobrist::hash(round) != hash_first);
+  }
+
+  SECTION("no collisions among many random trick states") {
+    std::mt19937_64 gen(4);
+    auto deck = test::double_deck();
+    std::unordered_map<Zobrist::Key, Composition> seen;
+    int num_collisions = 0;
+    for (int n = 0; n < 20000; ++n) {
+      std::shuffle(deck.begin(), deck.end(), gen);
+      std::vector<Card> cards;
+      const auto suit = rules.lorded_suit(deck[0]);
+      for (const auto& card : deck) {
+        if (rules.lorded_suit(card) == suit) cards.push_back(card);
+        if (cards.size() == static_cast<std::size_t>(1 + n % 8)) break;
+      }
+      const auto round = rules.start_round_with(cards);
+      const auto cmp = TestRules::parse(rules, cards);
+      const auto [it, inserted] = seen.emplace(Zobrist::hash(round), cmp);
+      if (!inserted and !(it->second == cmp)) ++num_collisions;
+    }
+    CHECK(num_collisions == 0);
+  }
+}
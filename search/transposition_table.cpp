@@ -0,0 +1,140 @@
+#include "search/transposition_table.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "profile/stats.hpp"
+
+namespace rankup {
+namespace {
+// layout of Slot::data: value in bits 0-15, depth in bits 16-23, bound in
+// bits 24-25 and generation in bits 32-39
+std::uint64_t pack(const TranspositionTable::Entry& entry,
+                   std::uint8_t generation) {
+  return static_cast<std::uint16_t>(entry.value) |
+         (static_cast<std::uint64_t>(entry.depth) << 16) |
+         (static_cast<std::uint64_t>(entry.bound) << 24) |
+         (static_cast<std::uint64_t>(generation) << 32);
+}
+
+std::uint8_t depth_of(std::uint64_t data) { return (data >> 16) & 0xff; }
+
+TranspositionTable::Bound bound_of(std::uint64_t data) {
+  return static_cast<TranspositionTable::Bound>((data >> 24) & 0x3);
+}
+
+std::uint8_t generation_of(std::uint64_t data) { return (data >> 32) & 0xff; }
+}  // namespace
+
+TranspositionTable::TranspositionTable(std::size_t memory_budget,
+                                       Replacement replacement)
+    : m_replacement(replacement) {
+  std::size_t num_buckets = memory_budget / sizeof(Bucket);
+  if (num_buckets == 0) {
+    RANKUP_STATS_COUNT(EXCEPTION);
+    throw std::runtime_error(
+        "TranspositionTable needs a memory budget of one bucket at least!");
+  }
+  // round down to a power of two so that the bucket of a key is a mask away
+  while (num_buckets & (num_buckets - 1)) num_buckets &= num_buckets - 1;
+  m_buckets = std::make_unique<Bucket[]>(num_buckets);
+  m_mask = num_buckets - 1;
+}
+
+TranspositionTable::~TranspositionTable() = default;
+
+std::optional<TranspositionTable::Entry> TranspositionTable::probe(
+    Zobrist::Key key) const noexcept {
+  const auto& bucket = bucket_of(key);
+  for (const auto& slot : bucket.slot) {
+    const auto check = slot.check.load(std::memory_order_relaxed);
+    const auto data = slot.data.load(std::memory_order_relaxed);
+    const auto once = slot.move_once.load(std::memory_order_relaxed);
+    const auto twice = slot.move_twice.load(std::memory_order_relaxed);
+    if ((check ^ data ^ once ^ twice) != key) continue;
+    if (bound_of(data) == Bound::NONE) continue;
+
+    Entry res;
+    res.value = static_cast<std::int16_t>(data & 0xffff);
+    res.depth = depth_of(data);
+    res.bound = bound_of(data);
+    res.best_move = CardSet(once, twice);
+    return res;
+  }
+  return std::nullopt;
+}
+
+void TranspositionTable::store(Zobrist::Key key, const Entry& entry) noexcept {
+  auto& bucket = bucket_of(key);
+
+  // a torn read below only leads to a worse choice of the slot, never to a
+  // corrupted entry
+  int same = -1;
+  std::uint64_t data[2];
+  for (int i = 0; i < 2; ++i) {
+    const auto& slot = bucket.slot[i];
+    data[i] = slot.data.load(std::memory_order_relaxed);
+    const auto check = slot.check.load(std::memory_order_relaxed) ^ data[i] ^
+                       slot.move_once.load(std::memory_order_relaxed) ^
+                       slot.move_twice.load(std::memory_order_relaxed);
+    if (check == key and same < 0) same = i;
+  }
+  // stale entries count as shallower than any entry of the current search
+  auto priority = [this](std::uint64_t d) {
+    return generation_of(d) == m_generation and bound_of(d) != Bound::NONE
+               ? depth_of(d) + 1
+               : 0;
+  };
+
+  int target = 0;
+  if (m_replacement == Replacement::ALWAYS) {
+    if (same >= 0)
+      target = same;
+    else
+      target = priority(data[1]) < priority(data[0]) ? 1 : 0;
+  } else {
+    target = (same == 0 or entry.depth + 1 >= priority(data[0])) ? 0 : 1;
+  }
+
+  const auto new_data = pack(entry, m_generation);
+  const auto once = entry.best_move.once();
+  const auto twice = entry.best_move.twice();
+  auto& slot = bucket.slot[target];
+  slot.data.store(new_data, std::memory_order_relaxed);
+  slot.move_once.store(once, std::memory_order_relaxed);
+  slot.move_twice.store(twice, std::memory_order_relaxed);
+  slot.check.store(key ^ new_data ^ once ^ twice, std::memory_order_relaxed);
+}
+
+void TranspositionTable::new_search() noexcept { ++m_generation; }
+
+void TranspositionTable::clear() noexcept {
+  for (std::size_t b = 0; b <= m_mask; ++b) {
+    for (auto& slot : m_buckets[b].slot) {
+      slot.check.store(0, std::memory_order_relaxed);
+      slot.data.store(0, std::memory_order_relaxed);
+      slot.move_once.store(0, std::memory_order_relaxed);
+      slot.move_twice.store(0, std::memory_order_relaxed);
+    }
+  }
+  m_generation = 0;
+}
+
+std::size_t TranspositionTable::memory() const noexcept {
+  return (m_mask + 1) * sizeof(Bucket);
+}
+
+double TranspositionTable::occupancy() const noexcept {
+  const std::size_t num_buckets = std::min<std::size_t>(m_mask + 1, 1024);
+  std::size_t num_used = 0;
+  for (std::size_t b = 0; b < num_buckets; ++b) {
+    for (const auto& slot : m_buckets[b].slot) {
+      const auto data = slot.data.load(std::memory_order_relaxed);
+      if (bound_of(data) != Bound::NONE and
+          generation_of(data) == m_generation)
+        ++num_used;
+    }
+  }
+  return static_cast<double>(num_used) / (2 * num_buckets);
+}
+}  // namespace rankup
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "common/card_set.hpp"
+#include "search/zobrist.hpp"
+
+namespace rankup {
+/**
+   A fixed-size hash table of searched positions shared by all search threads
+   without any lock.
+
+   Each entry stores its key xor-ed with its data, so an entry torn by
+   concurrent writes, or one belonging to another position, fails the check in
+   probe() and reads as a miss (Hyatt and Mann's lockless hashing). Entries
+   come in buckets of two filling a cache line, and the replacement policy
+   decides which of the two a store overwrites.
+ */
+class TranspositionTable {
+ public:
+  enum class Bound : std::uint8_t { NONE = 0, LOWER, UPPER, EXACT };
+
+  enum class Replacement : std::uint8_t {
+    // overwrite the entry of the same position if any, or else the shallower
+    // entry of the bucket
+    ALWAYS,
+    // keep the deepest entry of the current search in the first slot, and
+    // overwrite the second slot when a store cannot replace the first one
+    DEPTH_PREFERRED
+  };
+
+  struct Entry {
+    std::int16_t value = 0;
+    std::uint8_t depth = 0;
+    Bound bound = Bound::NONE;
+    CardSet best_move;
+  };
+
+  /**
+     @param memory_budget, the maximum number of bytes of the table, which is
+     rounded down to a power of two number of buckets.
+
+     @throw std::runtime_error if memory_budget is less than one bucket.
+   */
+  explicit TranspositionTable(
+      std::size_t memory_budget,
+      Replacement replacement = Replacement::DEPTH_PREFERRED);
+
+  ~TranspositionTable();
+
+  TranspositionTable(const TranspositionTable&) = delete;
+  TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+  /**
+     @return the entry stored for key, or nullopt if there is none
+   */
+  std::optional<Entry> probe(Zobrist::Key key) const noexcept;
+
+  void store(Zobrist::Key key, const Entry& entry) noexcept;
+
+  /**
+     Hint the cpu to load the bucket of key, so that a later probe or store of
+     key doesn't stall on memory.
+   */
+  void prefetch(Zobrist::Key key) const noexcept {
+    __builtin_prefetch(&bucket_of(key));
+  }
+
+  /**
+     Mark the entries of previous searches as stale, so that the
+     DEPTH_PREFERRED policy replaces them regardless of depth. Must not be
+     called concurrently with store().
+   */
+  void new_search() noexcept;
+
+  /**
+     Empty the table. Must not be called concurrently with other methods.
+   */
+  void clear() noexcept;
+
+  std::size_t num_entries() const noexcept { return 2 * (m_mask + 1); }
+
+  std::size_t memory() const noexcept;
+
+  /**
+     @return the fraction in [0, 1] of a sample of entries that are used by
+     the current search
+   */
+  double occupancy() const noexcept;
+
+ private:
+  // the xor of the key and the three data words
+  struct Slot {
+    std::atomic<std::uint64_t> check{0};
+    std::atomic<std::uint64_t> data{0};
+    std::atomic<std::uint64_t> move_once{0};
+    std::atomic<std::uint64_t> move_twice{0};
+  };
+
+  struct alignas(64) Bucket {
+    Slot slot[2];
+  };
+
+  std::unique_ptr<Bucket[]> m_buckets;
+  std::size_t m_mask;
+  Replacement m_replacement;
+  std::uint8_t m_generation = 0;
+
+  Bucket& bucket_of(Zobrist::Key key) const noexcept {
+    return m_buckets[key & m_mask];
+  }
+};
+}  // namespace rankup
@@ -0,0 +1,16 @@
+#include "search/zobrist.hpp"
+
+namespace rankup {
+// constexpr make_keys() makes this a constant initialization, free of static
+// initialization order issues
+const Zobrist::Keys Zobrist::KEYS = Zobrist::make_keys();
+
+Zobrist::Key Zobrist::hash(int seat, const CardSet& cards) noexcept {
+  Key res = 0;
+  for (auto m = cards.once(); m; m &= m - 1)
+    res ^= KEYS.card[seat][__builtin_ctzll(m)][0];
+  for (auto m = cards.twice(); m; m &= m - 1)
+    res ^= KEYS.card[seat][__builtin_ctzll(m)][1];
+  return res;
+}
+}  // namespace rankup
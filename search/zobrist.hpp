@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "common/card_set.hpp"
+#include "common/hash.hpp"
+#include "rules/rules.hpp"
+
+namespace rankup {
+/**
+   Zobrist keys of positions. Every copy of every card held by every seat has
+   its own random key, and a hand hashes to the xor of the keys of its cards,
+   so adding or removing a card updates the hash with a single xor.
+
+   The two copies of a card are told apart only by how many copies the hand
+   holds: the first copy added takes key 0 and the second takes key 1, so
+   equal hands hash equally regardless of the order of additions.
+ */
+class Zobrist {
+ public:
+  using Key = std::uint64_t;
+
+  /**
+     @return the key of the copy-th copy, 0 or 1, of card held by seat
+   */
+  static Key key(int seat, const Card& card, int copy) noexcept {
+    return KEYS.card[seat][card.index()][copy];
+  }
+
+  /**
+     @return the key of seat being the one to play next
+   */
+  static Key turn_key(int seat) noexcept { return KEYS.turn[seat]; }
+
+  /**
+     @return the key to xor into the hash of `before` held by seat when card
+     is added to it
+   */
+  static Key key_to_add(int seat, const CardSet& before,
+                        const Card& card) noexcept {
+    return key(seat, card, before.count(card));
+  }
+
+  /**
+     @return the key to xor into the hash of `before` held by seat when card
+     is removed from it
+   */
+  static Key key_to_remove(int seat, const CardSet& before,
+                           const Card& card) noexcept {
+    return key(seat, card, before.count(card) - 1);
+  }
+
+  /**
+     @return the hash of cards held by seat computed from scratch
+   */
+  static Key hash(int seat, const CardSet& cards) noexcept;
+
+  /**
+     @return the hash of the trick state of round
+   */
+  static Key hash(const RoundRules& round) noexcept {
+    return mix64(round.hash() ^ KEYS.trick);
+  }
+
+ private:
+  struct Keys {
+    std::array<std::array<std::array<Key, NUM_DECKS>, NUM_CARD_KINDS>,
+               NUM_SEATS>
+        card{};
+    std::array<Key, NUM_SEATS> turn{};
+    Key trick = 0;
+  };
+
+  // a fixed seed keeps hashes stable across runs, so that they can be stored
+  static constexpr Keys make_keys() {
+    Keys res;
+    std::uint64_t state = 0x52616e6b5570ULL;
+    for (auto& seat : res.card)
+      for (auto& kind : seat)
+        for (auto& key : kind) key = splitmix64(state);
+    for (auto& key : res.turn) key = splitmix64(state);
+    res.trick = splitmix64(state);
+    return res;
+  }
+
+  static const Keys KEYS;
+};
+
+/**
+   A hand of a seat together with its Zobrist hash, which is kept up to date
+   as cards are added and removed.
+ */
+class ZobristHand {
+ public:
+  explicit ZobristHand(int seat, const CardSet& cards = {})
+      : m_seat(seat), m_cards(cards), m_hash(Zobrist::hash(seat, cards)) {}
+
+  int seat() const noexcept { return m_seat; }
+  const CardSet& cards() const noexcept { return m_cards; }
+  Zobrist::Key hash() const noexcept { return m_hash; }
+
+  void add(const Card& card) noexcept {
+    m_hash ^= Zobrist::key_to_add(m_seat, m_cards, card);
+    m_cards.add(card);
+  }
+
+  void remove(const Card& card) noexcept {
+    m_hash ^= Zobrist::key_to_remove(m_seat, m_cards, card);
+    m_cards.remove(card);
+  }
+
+ private:
+  int m_seat;
+  CardSet m_cards;
+  Zobrist::Key m_hash;
+};
+}  // namespace rankup